@@ -0,0 +1,18 @@
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+#include <cstdint>
+
+// ================================
+// ALLOCATION COUNTER
+// ================================
+// Counts every call to the global operator new (all threads). The main loop
+// samples it once per frame to check that steady-state frames do not touch
+// the heap; raylib's own C allocations are not included.
+class AllocationCounter {
+public:
+    // Allocations since program start
+    static uint64_t GetCount();
+};
+
+#endif // ALLOCATION_COUNTER_H
\ No newline at end of file
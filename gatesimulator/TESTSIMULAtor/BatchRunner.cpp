@@ -0,0 +1,304 @@
+#include "BatchRunner.h"
+#include "CircuitFile.h"
+#include "WiringSystem.h"
+#include "LogicOptimizer.h"
+#include "LocalityOrder.h"
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <algorithm>
+
+// Resolve a manifest entry against the manifest's own directory
+static std::string ResolvePath(const std::string& base, const std::string& path) {
+    bool absolute = !path.empty() && (path[0] == '/' || path[0] == '\\' || (path.size() > 1 && path[1] == ':'));
+    return absolute || base.empty() ? path : base + path;
+}
+
+// ================================
+// BATCH RUNNER CLASS IMPLEMENTATION
+// ================================
+
+// Out-of-class definition: std::min takes the constant by reference
+constexpr int BatchRunner::CHUNK_BLOCKS;
+
+// Read the manifest
+bool BatchRunner::LoadManifest(const std::string& path, std::string& error) {
+    std::ifstream file(path);
+    if (!file) {
+        error = "cannot open " + path;
+        return false;
+    }
+
+    size_t slash = path.find_last_of("/\\");
+    std::string base = slash == std::string::npos ? "" : path.substr(0, slash + 1);
+
+    results.clear();
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        line = line.substr(0, line.find('#'));
+
+        std::istringstream fields(line);
+        std::string circuit, stimulus, expected;
+        if (!(fields >> circuit)) continue;
+        if (!(fields >> stimulus)) {
+            error = path + ":" + std::to_string(lineNumber) + ": expected 'circuit stimulus [expected]'";
+            return false;
+        }
+        fields >> expected;
+
+        JobResult result;
+        result.circuit = ResolvePath(base, circuit);
+        result.stimulus = ResolvePath(base, stimulus);
+        if (!expected.empty()) result.expected = ResolvePath(base, expected);
+        results.push_back(result);
+    }
+    return true;
+}
+
+// Run every job
+BatchRunner::Summary BatchRunner::Run(int threads) {
+    auto start = std::chrono::steady_clock::now();
+
+    if (threads <= 0) threads = (int)std::max(1u, std::thread::hardware_concurrency());
+    queues.clear();
+    for (int t = 0; t < threads; t++) queues.emplace_back(new WorkQueue());
+
+    // Deal the prepare tasks round-robin; chunks are spread by stealing
+    jobs.clear();
+    for (int j = 0; j < (int)results.size(); j++) {
+        jobs.emplace_back(new Job());
+        queues[j % threads]->tasks.push_back({ j, -1, 0 });
+    }
+    pendingTasks = (int)results.size();
+
+    std::vector<std::thread> workers;
+    for (int t = 1; t < threads; t++) workers.emplace_back(&BatchRunner::Worker, this, t);
+    Worker(0);
+    for (auto& worker : workers) worker.join();
+
+    Summary summary;
+    summary.jobs = (int)results.size();
+    summary.threads = threads;
+    for (const JobResult& result : results) {
+        if (result.passed) summary.passed++;
+        summary.vectors += result.vectors;
+    }
+    summary.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    jobs.clear();
+    return summary;
+}
+
+const std::vector<BatchRunner::JobResult>& BatchRunner::GetResults() const {
+    return results;
+}
+
+// Write per-job results and totals as a text table
+bool BatchRunner::WriteReport(const std::string& path, const Summary& summary, std::string& error) const {
+    std::ofstream file(path);
+    if (!file) {
+        error = "cannot write " + path;
+        return false;
+    }
+
+    file << "# result  vectors  mismatches  first_mismatch  seconds  vectors_per_s  circuit  stimulus  [error]\n";
+    for (const JobResult& result : results) {
+        file << (result.passed ? "PASS" : "FAIL") << "  " << result.vectors << "  " << result.mismatches << "  "
+            << result.firstMismatch << "  " << result.seconds << "  "
+            << (result.seconds > 0 ? (long long)(result.vectors / result.seconds) : 0) << "  "
+            << result.circuit << "  " << result.stimulus;
+        if (!result.error.empty()) file << "  # " << result.error;
+        file << "\n";
+    }
+
+    file << "# total: " << summary.passed << "/" << summary.jobs << " passed, " << summary.vectors << " vectors in "
+        << summary.seconds << " s on " << summary.threads << " threads";
+    if (summary.seconds > 0) file << " = " << (long long)(summary.vectors / summary.seconds) << " vectors/s";
+    file << "\n";
+    return (bool)file;
+}
+
+// Worker loop: run tasks from the own deque, steal when it is empty
+void BatchRunner::Worker(int self) {
+    std::vector<uint64_t> values;
+    Task task;
+
+    while (pendingTasks.load() > 0) {
+        if (!NextTask(self, task)) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        if (task.firstBlock < 0) {
+            Prepare(self, task.job);
+        }
+        else {
+            Evaluate(task, values);
+            if (--jobs[task.job]->remaining == 0) Finish(task.job);
+        }
+        pendingTasks--;
+    }
+}
+
+// Own deque first (newest task, still warm in cache), then the oldest task of another worker
+bool BatchRunner::NextTask(int self, Task& task) {
+    {
+        WorkQueue& own = *queues[self];
+        std::lock_guard<std::mutex> guard(own.lock);
+        if (!own.tasks.empty()) {
+            task = own.tasks.back();
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+
+    for (size_t k = 1; k < queues.size(); k++) {
+        WorkQueue& victim = *queues[(self + k) % queues.size()];
+        std::lock_guard<std::mutex> guard(victim.lock);
+        if (!victim.tasks.empty()) {
+            task = victim.tasks.front();
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void BatchRunner::Push(int self, const Task& task) {
+    pendingTasks++;
+    WorkQueue& own = *queues[self];
+    std::lock_guard<std::mutex> guard(own.lock);
+    own.tasks.push_back(task);
+}
+
+// Load and compile a job, then queue its vector chunks
+void BatchRunner::Prepare(int self, int j) {
+    Job& job = *jobs[j];
+    JobResult& result = results[j];
+    job.start = std::chrono::steady_clock::now();
+
+    std::vector<std::unique_ptr<Gate>> gates;
+    WiringSystem wiring;
+    if (!CircuitFile::LoadBench(result.circuit, gates, wiring, result.error)) {
+        Finish(j);
+        return;
+    }
+
+    LogicGraph raw;
+    raw.Build(gates, wiring);
+    job.graph = LogicOptimizer::Optimize(raw);
+    LocalityOrder::Apply(job.graph);
+
+    job.stimulus = PatternSet((int)job.graph.inputs.size());
+    if (!job.stimulus.Load(result.stimulus, result.error)) {
+        Finish(j);
+        return;
+    }
+
+    if (!result.expected.empty()) {
+        job.expected = PatternSet((int)job.graph.outputs.size());
+        job.hasExpected = true;
+        if (!job.expected.Load(result.expected, result.error)) {
+            Finish(j);
+            return;
+        }
+        if (job.expected.GetPatternCount() != job.stimulus.GetPatternCount()) {
+            result.error = result.expected + ": " + std::to_string(job.expected.GetPatternCount()) +
+                " results for " + std::to_string(job.stimulus.GetPatternCount()) + " vectors";
+            Finish(j);
+            return;
+        }
+    }
+
+    // Loop state runs through every vector, so a sequential job is not split
+    int blocks = job.stimulus.GetBlockCount();
+    int chunkBlocks = job.graph.loops.empty() ? CHUNK_BLOCKS : std::max(blocks, 1);
+    int chunks = (blocks + chunkBlocks - 1) / chunkBlocks;
+    if (chunks == 0) {
+        Finish(j);
+        return;
+    }
+
+    job.remaining = chunks;
+    for (int c = chunks - 1; c >= 0; c--) {
+        int first = c * chunkBlocks;
+        Push(self, { j, first, std::min(chunkBlocks, blocks - first) });
+    }
+}
+
+// Simulate one chunk and count mismatching vectors
+void BatchRunner::Evaluate(const Task& task, std::vector<uint64_t>& values) {
+    Job& job = *jobs[task.job];
+    const LogicGraph& graph = job.graph;
+    values.assign(graph.NodeCount(), 0);
+
+    long long mismatches = 0;
+    long long first = -1;
+    for (int block = task.firstBlock; block < task.firstBlock + task.blockCount; block++) {
+        uint64_t wrong = 0;
+        if (!graph.loops.empty()) {
+            wrong = EvaluateSequential(job, block, values);
+        }
+        else {
+            for (size_t i = 0; i < graph.inputs.size(); i++) {
+                values[graph.inputs[i]] = job.stimulus.Word(block, (int)i);
+            }
+            graph.Evaluate(values.data());
+            if (!job.hasExpected) continue;
+
+            for (size_t o = 0; o < graph.outputs.size(); o++) {
+                wrong |= values[graph.outputs[o]] ^ job.expected.Word(block, (int)o);
+            }
+        }
+        wrong &= job.stimulus.GetLaneMask(block);
+        if (wrong) {
+            mismatches += CountBits(wrong);
+            if (first < 0) first = (long long)block * 64 + LowestBit(wrong);
+        }
+    }
+
+    if (mismatches > 0) {
+        job.mismatches += mismatches;
+        long long seen = job.firstMismatch.load();
+        while ((seen < 0 || first < seen) && !job.firstMismatch.compare_exchange_weak(seen, first)) {
+        }
+    }
+}
+
+// Simulate one block of a sequential job vector by vector; every lane holds
+// the same vector, so the loop state left in values is that of the previous one
+uint64_t BatchRunner::EvaluateSequential(const Job& job, int block, std::vector<uint64_t>& values) const {
+    const LogicGraph& graph = job.graph;
+    int lanes = std::min(64, job.stimulus.GetPatternCount() - block * 64);
+
+    uint64_t wrong = 0;
+    for (int lane = 0; lane < lanes; lane++) {
+        for (size_t i = 0; i < graph.inputs.size(); i++) {
+            values[graph.inputs[i]] = (job.stimulus.Word(block, (int)i) >> lane) & 1 ? ~0ull : 0;
+        }
+        graph.Evaluate(values.data());
+        if (!job.hasExpected) continue;
+
+        for (size_t o = 0; o < graph.outputs.size(); o++) {
+            wrong |= ((values[graph.outputs[o]] ^ (job.expected.Word(block, (int)o) >> lane)) & 1) << lane;
+        }
+    }
+    return wrong;
+}
+
+// Record the result of a job whose last chunk is done and free its data
+void BatchRunner::Finish(int j) {
+    Job& job = *jobs[j];
+    JobResult& result = results[j];
+
+    result.vectors = result.error.empty() ? job.stimulus.GetPatternCount() : 0;
+    result.mismatches = job.mismatches;
+    result.firstMismatch = job.firstMismatch;
+    result.passed = result.error.empty() && result.mismatches == 0;
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - job.start).count();
+
+    job.graph = LogicGraph();
+    job.stimulus = PatternSet();
+    job.expected = PatternSet();
+}
\ No newline at end of file
@@ -0,0 +1,117 @@
+#ifndef BATCH_RUNNER_H
+#define BATCH_RUNNER_H
+
+#include "LogicGraph.h"
+#include "PatternSet.h"
+#include <vector>
+#include <deque>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// ================================
+// BATCH RUNNER CLASS DECLARATION
+// ================================
+// Regression runs of many circuits against their vector sets. The manifest
+// lists one job per line (# starts a comment, paths are relative to the
+// manifest):
+//
+//     circuit.bench  stimulus.txt  [expected.txt]
+//
+// A job passes when it loads and, if an expected results file is given,
+// every OUTPUT matches it. Jobs are scheduled on a work-stealing pool: a
+// worker prepares a job (load, compile, optimize) and pushes its vector
+// chunks onto its own deque, where idle workers steal them from the far end.
+//
+// A circuit with feedback loops is sequential and runs as --run does: its
+// whole vector set is one task, evaluated one vector at a time in file
+// order, so latches carry their state from each vector to the next.
+class BatchRunner {
+public:
+    struct JobResult {
+        std::string circuit;
+        std::string stimulus;
+        std::string expected;
+        long long vectors = 0;
+        long long mismatches = 0;       // Vectors with at least one wrong OUTPUT
+        long long firstMismatch = -1;
+        double seconds = 0.0;
+        bool passed = false;
+        std::string error;
+    };
+
+    struct Summary {
+        int jobs = 0;
+        int passed = 0;
+        long long vectors = 0;
+        double seconds = 0.0;
+        int threads = 0;
+    };
+
+    // Read the manifest
+    bool LoadManifest(const std::string& path, std::string& error);
+
+    // Run every job; threads = 0 uses every core
+    Summary Run(int threads = 0);
+
+    const std::vector<JobResult>& GetResults() const;
+
+    // Write per-job results and totals as a text table
+    bool WriteReport(const std::string& path, const Summary& summary, std::string& error) const;
+
+private:
+    static constexpr int CHUNK_BLOCKS = 256;    // 16384 vectors per task
+
+    // One unit of work: prepare a job (firstBlock < 0) or evaluate a block range
+    struct Task {
+        int job;
+        int firstBlock;
+        int blockCount;
+    };
+
+    // Per-job state shared by its chunks
+    struct Job {
+        LogicGraph graph;
+        PatternSet stimulus;
+        PatternSet expected;
+        bool hasExpected = false;
+        std::atomic<int> remaining{ 0 };            // Chunks not finished yet
+        std::atomic<long long> mismatches{ 0 };
+        std::atomic<long long> firstMismatch{ -1 };
+        std::chrono::steady_clock::time_point start;
+    };
+
+    // Deque of one worker; the owner uses the back, thieves the front
+    struct WorkQueue {
+        std::mutex lock;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<JobResult> results;
+    std::vector<std::unique_ptr<Job>> jobs;
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    std::atomic<int> pendingTasks{ 0 };    // Queued or running; workers stop at zero
+
+    // Worker loop: run tasks from the own deque, steal when it is empty
+    void Worker(int self);
+    bool NextTask(int self, Task& task);
+    void Push(int self, const Task& task);
+
+    // Load and compile a job, then queue its vector chunks
+    void Prepare(int self, int job);
+
+    // Simulate one chunk and count mismatching vectors
+    void Evaluate(const Task& task, std::vector<uint64_t>& values);
+
+    // Simulate one block of a sequential job vector by vector; returns the
+    // lanes with a wrong OUTPUT
+    uint64_t EvaluateSequential(const Job& job, int block, std::vector<uint64_t>& values) const;
+
+    // Record the result of a job whose last chunk is done and free its data
+    void Finish(int job);
+};
+
+#endif // BATCH_RUNNER_H
\ No newline at end of file
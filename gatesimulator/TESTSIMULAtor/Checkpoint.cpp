@@ -0,0 +1,102 @@
+#include "Checkpoint.h"
+#include <fstream>
+#include <cstring>
+
+namespace {
+
+const char MAGIC[4] = { 'G', 'S', 'C', 'P' };
+const uint32_t FORMAT_VERSION = 2;     // Version 1 stored one byte per switch
+
+struct Header {
+    char magic[4];
+    uint32_t version;
+    uint64_t fingerprint;
+    uint32_t optimized;
+    uint32_t nodeCount;
+    uint32_t switchCount;
+    uint32_t fourValued;                // Zero in files written before four-valued mode
+};
+
+} // namespace
+
+// ================================
+// CHECKPOINT CLASS IMPLEMENTATION
+// ================================
+
+bool Checkpoint::IsEmpty() const {
+    return nodeValues.empty();
+}
+
+// Size of the binary form in bytes
+size_t Checkpoint::GetByteSize() const {
+    return sizeof(Header) + (nodeValues.size() + switches.size()) * sizeof(uint64_t);
+}
+
+// Write the header and both arrays (host byte order)
+bool Checkpoint::Save(const std::string& path, std::string& error) const {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) {
+        error = "cannot write " + path;
+        return false;
+    }
+
+    Header header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = FORMAT_VERSION;
+    header.fingerprint = fingerprint;
+    header.optimized = optimized ? 1 : 0;
+    header.fourValued = fourValued ? 1 : 0;
+    header.nodeCount = (uint32_t)nodeValues.size();
+    header.switchCount = (uint32_t)switches.size();
+
+    out.write((const char*)&header, sizeof(header));
+    out.write((const char*)nodeValues.data(), nodeValues.size() * sizeof(uint64_t));
+    out.write((const char*)switches.data(), switches.size() * sizeof(uint64_t));
+    if (!out) {
+        error = "write failed: " + path;
+        return false;
+    }
+    return true;
+}
+
+// Read a checkpoint written by Save()
+bool Checkpoint::Load(const std::string& path, std::string& error) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        error = "cannot open " + path;
+        return false;
+    }
+
+    Header header;
+    if (!in.read((char*)&header, sizeof(header)) || std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        error = path + ": not a checkpoint";
+        return false;
+    }
+    if (header.version != FORMAT_VERSION && header.version != 1) {
+        error = path + ": unsupported checkpoint version " + std::to_string(header.version);
+        return false;
+    }
+
+    std::vector<uint64_t> values(header.nodeCount);
+    std::vector<uint64_t> states(header.switchCount);
+    in.read((char*)values.data(), values.size() * sizeof(uint64_t));
+    if (header.version == 1) {
+        std::vector<unsigned char> bytes(header.switchCount);
+        in.read((char*)bytes.data(), bytes.size());
+        states.assign(bytes.begin(), bytes.end());
+    }
+    else {
+        in.read((char*)states.data(), states.size() * sizeof(uint64_t));
+    }
+    if (!in) {
+        error = path + ": truncated checkpoint";
+        return false;
+    }
+
+    fingerprint = header.fingerprint;
+    optimized = header.optimized != 0;
+    fourValued = header.fourValued != 0;
+    nodeValues.swap(values);
+    switches.swap(states);
+    return true;
+}
\ No newline at end of file
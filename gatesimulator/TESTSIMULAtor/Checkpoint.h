@@ -0,0 +1,35 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+// ================================
+// CHECKPOINT CLASS DECLARATION
+// ================================
+// Snapshot of the simulation state of one circuit, taken and restored by
+// WiringSystem. The node words of the compiled graph carry every gate and
+// wire signal, including what latches hold, so together with the INPUT
+// switches they are the whole state: both directions are a copy of these
+// arrays. A checkpoint only restores into the circuit it was taken from, as
+// identified by its structure fingerprint and evaluation mode.
+class Checkpoint {
+public:
+    uint64_t fingerprint = 0;           // Gate types and connections of the circuit
+    bool optimized = false;             // Taken while evaluating the optimized netlist
+    bool fourValued = false;            // Taken while evaluating 0/1/X/Z
+    std::vector<uint64_t> nodeValues;   // One word per compiled node (two bit-planes each if four-valued)
+    std::vector<uint64_t> switches;     // INPUT gate switch values (words of bus INPUTs), in gate order
+
+    bool IsEmpty() const;
+
+    // Size of the binary form in bytes
+    size_t GetByteSize() const;
+
+    // Binary form: a small header, then both arrays as stored in memory
+    bool Save(const std::string& path, std::string& error) const;
+    bool Load(const std::string& path, std::string& error);
+};
+
+#endif // CHECKPOINT_H
\ No newline at end of file
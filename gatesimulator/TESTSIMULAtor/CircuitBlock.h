@@ -0,0 +1,40 @@
+#ifndef CIRCUIT_BLOCK_H
+#define CIRCUIT_BLOCK_H
+
+#include "raylib.h"
+#include "Constants.h"
+#include <vector>
+#include <cstdint>
+
+// ================================
+// CIRCUIT BLOCK
+// ================================
+// Gates copied out of a circuit together with the wires running between
+// them (wires to gates outside the block are left behind). Positions are
+// relative to the top-left corner of the block's bounding box.
+struct CircuitBlock {
+    struct GateCopy {
+        GateType type;
+        int inputCount;
+        int width;              // Bus width, 1 for a plain gate
+        int sliceOffset;        // First bit taken by a SPLIT
+        uint64_t state;         // Switch value of an INPUT gate (the word of a bus INPUT)
+        Vector2 offset;
+    };
+
+    struct WireCopy {
+        int fromGate;           // Indices into gates
+        int toGate;
+        int toInput;
+    };
+
+    std::vector<GateCopy> gates;
+    std::vector<WireCopy> wires;
+    Vector2 size = { 0, 0 };
+
+    bool IsEmpty() const {
+        return gates.empty();
+    }
+};
+
+#endif // CIRCUIT_BLOCK_H
\ No newline at end of file
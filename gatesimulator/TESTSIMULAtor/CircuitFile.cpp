@@ -0,0 +1,369 @@
+#include "CircuitFile.h"
+#include "WiringSystem.h"
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#include <map>
+#include <deque>
+#include <algorithm>
+#include <cctype>
+
+// ================================
+// BENCH PARSING HELPERS
+// ================================
+namespace {
+
+const char* UNCONNECTED_NET = "NC";
+
+// One gate to be created, named by the net it drives
+struct GateSpec {
+    GateType type;
+    std::string net;
+    std::vector<std::string> fanin;
+};
+
+std::string Trim(const std::string& text) {
+    size_t first = text.find_first_not_of(" \t\r\n");
+    if (first == std::string::npos) return "";
+    size_t last = text.find_last_not_of(" \t\r\n");
+    return text.substr(first, last - first + 1);
+}
+
+std::string Upper(std::string text) {
+    for (char& c : text) c = (char)std::toupper((unsigned char)c);
+    return text;
+}
+
+// Split "NAME(a, b, c)" into NAME and its arguments
+bool ParseCall(const std::string& text, std::string& name, std::vector<std::string>& args) {
+    size_t open = text.find('(');
+    size_t close = text.rfind(')');
+    if (open == std::string::npos || close == std::string::npos || close < open) return false;
+
+    name = Upper(Trim(text.substr(0, open)));
+    args.clear();
+
+    std::stringstream list(text.substr(open + 1, close - open - 1));
+    std::string arg;
+    while (std::getline(list, arg, ',')) {
+        arg = Trim(arg);
+        if (!arg.empty()) args.push_back(arg);
+    }
+    return true;
+}
+
+// Emit specs for a multi-input AND/OR/NAND/NOR, splitting only past MAX_GATE_INPUTS
+void AddWideGate(GateType type, const std::string& net, std::vector<std::string> fanin,
+    std::vector<GateSpec>& specs, int& tempCounter) {
+    // Inner tree nodes use the non-inverting form; only the root inverts
+    GateType inner = (type == GateType::NAND || type == GateType::AND) ? GateType::AND : GateType::OR;
+
+    while ((int)fanin.size() > MAX_GATE_INPUTS) {
+        std::vector<std::string> next;
+        for (size_t i = 0; i < fanin.size(); i += MAX_GATE_INPUTS) {
+            size_t end = std::min(fanin.size(), i + MAX_GATE_INPUTS);
+            if (end - i == 1) {
+                next.push_back(fanin[i]);
+                continue;
+            }
+            std::string temp = net + "$t" + std::to_string(tempCounter++);
+            specs.push_back({ inner, temp, std::vector<std::string>(fanin.begin() + i, fanin.begin() + end) });
+            next.push_back(temp);
+        }
+        fanin.swap(next);
+    }
+
+    specs.push_back({ type, net, fanin });
+}
+
+// XOR(a, b) = NAND(NAND(a, n), NAND(b, n)) with n = NAND(a, b), chained for wider XORs
+void AddXorChain(const std::string& net, const std::vector<std::string>& fanin,
+    std::vector<GateSpec>& specs, int& tempCounter) {
+    std::string acc = fanin[0];
+    for (size_t i = 1; i < fanin.size(); i++) {
+        std::string out = (i + 1 == fanin.size()) ? net : net + "$t" + std::to_string(tempCounter++);
+        std::string n = net + "$t" + std::to_string(tempCounter++);
+        std::string l = net + "$t" + std::to_string(tempCounter++);
+        std::string r = net + "$t" + std::to_string(tempCounter++);
+
+        specs.push_back({ GateType::NAND, n, { acc, fanin[i] } });
+        specs.push_back({ GateType::NAND, l, { acc, n } });
+        specs.push_back({ GateType::NAND, r, { fanin[i], n } });
+        specs.push_back({ GateType::NAND, out, { l, r } });
+        acc = out;
+    }
+}
+
+} // namespace
+
+// ================================
+// CIRCUIT FILE CLASS IMPLEMENTATION
+// ================================
+
+// Replace the current circuit with the contents of a .bench file
+bool CircuitFile::LoadBench(const std::string& path, std::vector<std::unique_ptr<Gate>>& gates,
+    WiringSystem& wiring, std::string& error) {
+    std::ifstream file(path);
+    if (!file) {
+        error = "cannot open " + path;
+        return false;
+    }
+
+    std::vector<GateSpec> specs;
+    std::vector<std::string> outputNets;
+    std::unordered_map<std::string, std::string> aliases;      // BUFF nets
+    std::unordered_map<std::string, Vector2> gatePositions;
+    std::map<std::string, std::deque<Vector2>> outputPositions;
+    int tempCounter = 0;
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+
+        // Placement comments written by SaveBench
+        if (line.compare(0, 2, "#@") == 0) {
+            std::stringstream meta(line.substr(2));
+            std::string kind, net;
+            Vector2 pos;
+            if (meta >> kind >> net >> pos.x >> pos.y) {
+                if (kind == "gate") gatePositions[net] = pos;
+                else if (kind == "out") outputPositions[net].push_back(pos);
+            }
+            continue;
+        }
+
+        line = Trim(line.substr(0, line.find('#')));
+        if (line.empty()) continue;
+
+        std::string name;
+        std::vector<std::string> args;
+        size_t eq = line.find('=');
+
+        if (eq == std::string::npos) {
+            if (!ParseCall(line, name, args) || args.size() != 1) {
+                error = path + ":" + std::to_string(lineNumber) + ": malformed declaration";
+                return false;
+            }
+            if (name == "INPUT") specs.push_back({ GateType::INPUT, args[0], {} });
+            else if (name == "OUTPUT") outputNets.push_back(args[0]);
+            else {
+                error = path + ":" + std::to_string(lineNumber) + ": unknown declaration " + name;
+                return false;
+            }
+            continue;
+        }
+
+        std::string net = Trim(line.substr(0, eq));
+        if (!ParseCall(line.substr(eq + 1), name, args) || args.empty()) {
+            error = path + ":" + std::to_string(lineNumber) + ": malformed gate";
+            return false;
+        }
+
+        if (name == "BUFF" || name == "BUF" ||
+            (args.size() == 1 && (name == "AND" || name == "OR"))) {
+            aliases[net] = args[0];
+        }
+        else if (name == "NOT" || (args.size() == 1 && (name == "NAND" || name == "NOR"))) {
+            specs.push_back({ GateType::NOT, net, { args[0] } });
+        }
+        else if (name == "AND" || name == "OR" || name == "NAND" || name == "NOR") {
+            GateType type = name == "AND" ? GateType::AND : name == "OR" ? GateType::OR :
+                name == "NAND" ? GateType::NAND : GateType::NOR;
+            AddWideGate(type, net, args, specs, tempCounter);
+        }
+        else if (name == "XOR" || name == "XNOR") {
+            if (args.size() == 1) {
+                aliases[net] = args[0];
+            }
+            else if (name == "XOR") {
+                AddXorChain(net, args, specs, tempCounter);
+            }
+            else {
+                std::string inner = net + "$t" + std::to_string(tempCounter++);
+                AddXorChain(inner, args, specs, tempCounter);
+                specs.push_back({ GateType::NOT, net, { inner } });
+            }
+        }
+        else {
+            error = path + ":" + std::to_string(lineNumber) + ": unsupported gate " + name;
+            return false;
+        }
+    }
+
+    for (const std::string& net : outputNets) {
+        specs.push_back({ GateType::OUTPUT, "", { net } });
+    }
+
+    // Resolve BUFF chains down to a real driver
+    auto resolve = [&aliases](std::string net) {
+        for (size_t hops = 0; hops <= aliases.size(); hops++) {
+            auto it = aliases.find(net);
+            if (it == aliases.end()) break;
+            net = it->second;
+        }
+        return net;
+    };
+
+    std::unordered_map<std::string, int> driver;
+    for (int i = 0; i < (int)specs.size(); i++) {
+        if (!specs[i].net.empty()) driver[specs[i].net] = i;
+    }
+
+    // Resolve every fanin to a spec index (-1 = unconnected)
+    std::vector<std::vector<int>> faninSpec(specs.size());
+    for (int i = 0; i < (int)specs.size(); i++) {
+        for (const std::string& name : specs[i].fanin) {
+            std::string net = resolve(name);
+            if (net == UNCONNECTED_NET) {
+                faninSpec[i].push_back(-1);
+                continue;
+            }
+            auto it = driver.find(net);
+            if (it == driver.end()) {
+                error = path + ": undefined net " + name;
+                return false;
+            }
+            faninSpec[i].push_back(it->second);
+        }
+    }
+
+    // Logic level of every spec (longest path from the inputs), iteratively;
+    // a fanin that is still on the stack closes a loop and is ignored
+    std::vector<int> level(specs.size(), -1);
+    std::vector<unsigned char> onStack(specs.size(), 0);
+    std::vector<int> stack;
+    for (int root = 0; root < (int)specs.size(); root++) {
+        if (level[root] >= 0) continue;
+        stack.push_back(root);
+        onStack[root] = 1;
+        while (!stack.empty()) {
+            int s = stack.back();
+            bool ready = true;
+            for (int f : faninSpec[s]) {
+                if (f >= 0 && level[f] < 0 && !onStack[f]) {
+                    stack.push_back(f);
+                    onStack[f] = 1;
+                    ready = false;
+                }
+            }
+            if (!ready) continue;
+
+            int best = 0;
+            for (int f : faninSpec[s]) {
+                if (f >= 0 && level[f] >= 0) best = std::max(best, level[f] + 1);
+            }
+            level[s] = best;
+            onStack[s] = 0;
+            stack.pop_back();
+        }
+    }
+
+    // Lay out by level unless the file carries positions
+    std::vector<float> columnY;
+    std::vector<Vector2> positions(specs.size());
+    for (int i = 0; i < (int)specs.size(); i++) {
+        const GateSpec& spec = specs[i];
+        if (spec.type == GateType::OUTPUT) {
+            auto it = outputPositions.find(spec.fanin[0]);
+            if (it != outputPositions.end() && !it->second.empty()) {
+                positions[i] = it->second.front();
+                it->second.pop_front();
+                continue;
+            }
+        }
+        else {
+            auto it = gatePositions.find(spec.net);
+            if (it != gatePositions.end()) {
+                positions[i] = it->second;
+                continue;
+            }
+        }
+
+        if ((int)columnY.size() <= level[i]) columnY.resize(level[i] + 1, 60.0f);
+        Gate probe(spec.type, { 0, 0 }, (int)spec.fanin.size());
+        positions[i] = { SIDEBAR_WIDTH + 60.0f + level[i] * 140.0f, columnY[level[i]] };
+        columnY[level[i]] += probe.GetSize().y + 20.0f;
+    }
+
+    // Build the circuit; loading is not an undoable edit
+    wiring.Clear(gates);
+    for (int i = 0; i < (int)specs.size(); i++) {
+        wiring.InsertGate(i, std::make_unique<Gate>(specs[i].type, positions[i], (int)specs[i].fanin.size()), gates);
+    }
+    for (int i = 0; i < (int)specs.size(); i++) {
+        for (int pin = 0; pin < (int)faninSpec[i].size(); pin++) {
+            if (faninSpec[i][pin] >= 0) {
+                wiring.ConnectWire(faninSpec[i][pin], i, pin, gates);
+            }
+        }
+    }
+    return true;
+}
+
+// Write the current circuit as a .bench file (1-bit nets only)
+bool CircuitFile::SaveBench(const std::string& path, const std::vector<std::unique_ptr<Gate>>& gates,
+    const WiringSystem& wiring, std::string& error) {
+    for (const auto& gate : gates) {
+        if (gate->IsBus() || gate->GetType() == GateType::SPLIT || gate->GetType() == GateType::MERGE) {
+            error = "buses cannot be saved as .bench";
+            return false;
+        }
+    }
+
+    std::ofstream file(path);
+    if (!file) {
+        error = "cannot write " + path;
+        return false;
+    }
+
+    auto netName = [](int gateIndex) { return "G" + std::to_string(gateIndex); };
+    auto faninName = [&](int gateIndex, int pin) {
+        Wire* wire = wiring.GetFaninWire(gateIndex, pin);
+        return wire ? netName(wire->fromGateIndex) : std::string(UNCONNECTED_NET);
+    };
+
+    file << "# Logic Gate Simulator circuit: " << gates.size() << " gates\n";
+
+    for (int g = 0; g < (int)gates.size(); g++) {
+        if (gates[g]->GetType() == GateType::INPUT) {
+            file << "INPUT(" << netName(g) << ")\n";
+        }
+    }
+    for (int g = 0; g < (int)gates.size(); g++) {
+        if (gates[g]->GetType() == GateType::OUTPUT) {
+            file << "OUTPUT(" << faninName(g, 0) << ")\n";
+        }
+    }
+    file << "\n";
+
+    for (int g = 0; g < (int)gates.size(); g++) {
+        const Gate& gate = *gates[g];
+        if (gate.GetType() == GateType::INPUT || gate.GetType() == GateType::OUTPUT) continue;
+
+        file << netName(g) << " = " << gate.GetLabel() << "(";
+        for (int pin = 0; pin < gate.GetInputCount(); pin++) {
+            file << (pin ? ", " : "") << faninName(g, pin);
+        }
+        file << ")\n";
+    }
+    file << "\n";
+
+    // Placement, ignored by other tools
+    for (int g = 0; g < (int)gates.size(); g++) {
+        const Gate& gate = *gates[g];
+        if (gate.GetType() == GateType::OUTPUT) {
+            file << "#@out " << faninName(g, 0);
+        }
+        else {
+            file << "#@gate " << netName(g);
+        }
+        file << " " << gate.position.x << " " << gate.position.y << "\n";
+    }
+
+    if (!file) {
+        error = "write failed for " + path;
+        return false;
+    }
+    return true;
+}
\ No newline at end of file
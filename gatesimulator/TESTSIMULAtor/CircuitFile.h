@@ -0,0 +1,40 @@
+#ifndef CIRCUIT_FILE_H
+#define CIRCUIT_FILE_H
+
+#include "raylib.h"
+#include "Constants.h"
+#include "Gate.h"
+#include <vector>
+#include <memory>
+#include <string>
+
+// Forward declaration to avoid circular dependency
+class WiringSystem;
+
+// ================================
+// CIRCUIT FILE CLASS DECLARATION
+// ================================
+// Reads and writes circuits in the ISCAS .bench netlist format:
+//
+//     INPUT(a)
+//     OUTPUT(y)
+//     y = NAND(a, b, c)
+//
+// Wide AND/OR/NAND/NOR gates map directly onto N-input gates (split into a
+// tree only beyond MAX_GATE_INPUTS), BUFF nets are aliased away, and XOR/XNOR
+// are built from NAND gates. Unconnected pins are written as the reserved net
+// NC, and placement is kept in "#@gate"/"#@out" comments that other tools
+// ignore; files without them are laid out by logic level.
+class CircuitFile {
+public:
+    // Replace the current circuit with the contents of a .bench file
+    static bool LoadBench(const std::string& path, std::vector<std::unique_ptr<Gate>>& gates,
+        WiringSystem& wiring, std::string& error);
+
+    // Write the current circuit as a .bench file; fails on circuits with buses,
+    // which .bench cannot express
+    static bool SaveBench(const std::string& path, const std::vector<std::unique_ptr<Gate>>& gates,
+        const WiringSystem& wiring, std::string& error);
+};
+
+#endif // CIRCUIT_FILE_H
\ No newline at end of file
@@ -0,0 +1,86 @@
+#include "CircuitTrace.h"
+#include "WiringSystem.h"
+
+// ================================
+// CIRCUIT TRACE CLASS IMPLEMENTATION
+// ================================
+
+// Start tracing a set of gates (with their wires) or the whole circuit
+bool CircuitTrace::Start(const std::string& path, const std::vector<std::unique_ptr<Gate>>& gates,
+    const WiringSystem& wiring, const std::vector<int>& gateIndices, std::string& error) {
+    Stop();
+    writer.reset(new VcdWriter());
+    gateProbes.clear();
+    wireProbes.clear();
+
+    std::vector<char> traced(gates.size(), gateIndices.empty() ? 1 : 0);
+    for (int g : gateIndices) {
+        if (g >= 0 && g < (int)gates.size()) traced[g] = 1;
+    }
+
+    for (int g = 0; g < (int)gates.size(); g++) {
+        if (traced[g]) AddGate(g, *gates[g]);
+    }
+    for (int g = 0; g < (int)gates.size(); g++) {
+        for (Wire* wire : wiring.GetFanoutWires(g)) {
+            if (traced[wire->fromGateIndex] || traced[wire->toGateIndex]) AddWire(*wire);
+        }
+    }
+
+    if (!writer->Open(path, "1 ms", error)) {
+        writer.reset();
+        return false;
+    }
+    structureVersion = wiring.GetStructureVersion();
+    startTime = -1.0;
+    return true;
+}
+
+// Record this frame's values; only changes reach the file
+void CircuitTrace::Sample(double time, const WiringSystem& wiring) {
+    if (!IsActive()) return;
+    if (wiring.GetStructureVersion() != structureVersion) {
+        Stop();
+        return;
+    }
+
+    if (startTime < 0) startTime = time;
+    uint64_t ms = (uint64_t)((time - startTime) * 1000.0);
+
+    int signal = 0;
+    for (const Gate* gate : gateProbes) {
+        if (gate->GetWidth() > 1) writer->SampleBus(ms, signal++, gate->busValue, gate->outputLevel == Logic::X);
+        else writer->Sample(ms, signal++, gate->outputLevel);
+    }
+    for (const Wire* wire : wireProbes) {
+        if (wire->width > 1) writer->SampleBus(ms, signal++, wire->busValue, wire->level == Logic::X);
+        else writer->Sample(ms, signal++, wire->level);
+    }
+}
+
+void CircuitTrace::Stop() {
+    if (writer) writer->Close();
+}
+
+bool CircuitTrace::IsActive() const {
+    return writer && writer->IsOpen();
+}
+
+size_t CircuitTrace::GetSignalCount() const {
+    return writer ? writer->GetSignalCount() : 0;
+}
+
+uint64_t CircuitTrace::GetChangeCount() const {
+    return writer ? writer->GetChangeCount() : 0;
+}
+
+void CircuitTrace::AddGate(int gateIndex, const Gate& gate) {
+    writer->AddSignal("G" + std::to_string(gateIndex) + "_" + gate.GetLabel(), gate.GetWidth());
+    gateProbes.push_back(&gate);
+}
+
+void CircuitTrace::AddWire(const Wire& wire) {
+    writer->AddSignal("G" + std::to_string(wire.fromGateIndex) + "_to_G" + std::to_string(wire.toGateIndex) +
+        "_in" + std::to_string(wire.toInputIndex), wire.width);
+    wireProbes.push_back(&wire);
+}
\ No newline at end of file
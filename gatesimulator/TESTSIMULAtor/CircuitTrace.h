@@ -0,0 +1,48 @@
+#ifndef CIRCUIT_TRACE_H
+#define CIRCUIT_TRACE_H
+
+#include "Gate.h"
+#include "Wire.h"
+#include "VcdWriter.h"
+#include <vector>
+#include <memory>
+#include <string>
+
+// Forward declaration to avoid circular dependency
+class WiringSystem;
+
+// ================================
+// CIRCUIT TRACE CLASS DECLARATION
+// ================================
+// Records Gate::outputLevel and Wire::level of the interactive circuit into
+// a VCD file, so X and Z of four-valued evaluation are dumped as x and z.
+// Bus gates and wires are dumped as vectors of their width from busValue.
+// Signals are bound when tracing starts: either a set of gates with the wires
+// on their pins, or the whole circuit. Any structural edit ends the trace, since
+// the bound gates and wires may no longer exist.
+class CircuitTrace {
+public:
+    // Start tracing; an empty gateIndices traces every gate and wire
+    bool Start(const std::string& path, const std::vector<std::unique_ptr<Gate>>& gates,
+        const WiringSystem& wiring, const std::vector<int>& gateIndices, std::string& error);
+
+    // Record this frame's values; time is in seconds
+    void Sample(double time, const WiringSystem& wiring);
+
+    void Stop();
+    bool IsActive() const;
+    size_t GetSignalCount() const;
+    uint64_t GetChangeCount() const;
+
+private:
+    std::unique_ptr<VcdWriter> writer;
+    std::vector<const Gate*> gateProbes;    // Signal ids 0 .. gateProbes.size() - 1
+    std::vector<const Wire*> wireProbes;    // Followed by one id per wire
+    unsigned int structureVersion = 0;
+    double startTime = -1.0;
+
+    void AddGate(int gateIndex, const Gate& gate);
+    void AddWire(const Wire& wire);
+};
+
+#endif // CIRCUIT_TRACE_H
\ No newline at end of file
@@ -2,7 +2,11 @@
 #define CONSTANTS_H
 
 #include "raylib.h"
-#include <map>
+#include <cstddef>
+#include <cstdint>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
 // CONSTANTS AND CONFIGURATION
 // ================================
@@ -11,12 +15,49 @@ const int SCREEN_HEIGHT = 880;
 const int SIDEBAR_WIDTH = 200;
 const float CONNECTION_POINT_RADIUS = 6.0f;
 const float CONNECTION_SNAP_DISTANCE = 15.0f;
+const int MAX_GATE_INPUTS = 16;          // Widest AND/OR/NAND/NOR gate
+const float INPUT_PIN_SPACING = 16.0f;   // Vertical distance between input pins
+const size_t HISTORY_MEMORY_LIMIT = 16 * 1024 * 1024;  // Undo/redo journal cap in bytes
+const int MAX_LOOP_ITERATIONS = 64;      // Fixpoint passes over a combinational loop before it counts as oscillating
+const int PARALLEL_MIN_LEVEL_NODES = 4096; // Narrower levels are evaluated by a single thread
+const int CACHE_MODEL_BYTES = 32 * 1024; // Data cache modelled by the locality report (a typical L1)
+const int CACHE_MODEL_WAYS = 8;
+const int CACHE_LINE_BYTES = 64;
+const float WIRE_PICK_DISTANCE = 10.0f;  // How close the cursor must be to a wire to hit it
+const float WIRE_HASH_CELL_SIZE = 64.0f; // Cell edge of the wire segment spatial hash
+const float GATE_GRID_CELL_SIZE = 128.0f; // Cell edge of the gate bounds spatial hash
+const int MAX_BUS_WIDTH = 64;            // Bits carried by one bus wire (one uint64_t)
+
+// Low `width` bits set
+constexpr uint64_t BusMask(int width) {
+    return width >= 64 ? ~0ull : (1ull << width) - 1;
+}
+
+// Number of set bits
+inline int CountBits(uint64_t word) {
+#ifdef _MSC_VER
+    return (int)__popcnt64(word);
+#else
+    return __builtin_popcountll(word);
+#endif
+}
+
+// Index of the lowest set bit (word must be non-zero)
+inline int LowestBit(uint64_t word) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return (int)index;
+#else
+    return __builtin_ctzll(word);
+#endif
+}
 
 
 // ENUMS AND DATA STRUCTURES
 // ================================
 enum class GateType {
-    INPUT, OUTPUT, AND, OR, NOT, NAND, NOR
+    INPUT, OUTPUT, AND, OR, NOT, NAND, NOR, SPLIT, MERGE
 };
 
 enum class SimulatorMode {
@@ -27,26 +68,75 @@ struct GateInfo {
     Vector2 size;
     Color color;
     const char* label;
+    int minInputs;          // Pin count range (INPUT gates have no pins)
+    int maxInputs;
+    int defaultInputs;
+    bool andReduce;         // Output reduces the pins with AND, otherwise with OR
+    bool inverting;         // Output is the complement of that reduction
 };
 
-// Lookup table for gate properties
-static const std::map<GateType, GateInfo> GATE_DATA = {
-    {GateType::INPUT, {{60, 40}, LIGHTGRAY, "INP"}},
-    {GateType::OUTPUT, {{60, 40}, SKYBLUE, "OUT"}},
-    {GateType::AND, {{75, 50}, DARKGREEN, "AND"}},
-    {GateType::OR, {{75, 50}, DARKBLUE, "OR"}},
-    {GateType::NOT, {{75, 50}, MAROON, "NOT"}},
-    {GateType::NAND, {{75, 50}, LIME, "NAND"}},
-    {GateType::NOR, {{75, 50}, PURPLE, "NOR"}}
+// Lookup table for gate properties, indexed by GateType (keep in enum order)
+constexpr GateInfo GATE_DATA[] = {
+    {{60, 40}, LIGHTGRAY, "INP", 0, 0, 0, false, false},
+    {{60, 40}, SKYBLUE, "OUT", 1, 1, 1, false, false},
+    {{75, 50}, DARKGREEN, "AND", 2, MAX_GATE_INPUTS, 2, true, false},
+    {{75, 50}, DARKBLUE, "OR", 2, MAX_GATE_INPUTS, 2, false, false},
+    {{75, 50}, MAROON, "NOT", 1, 1, 1, false, true},
+    {{75, 50}, LIME, "NAND", 2, MAX_GATE_INPUTS, 2, true, true},
+    {{75, 50}, PURPLE, "NOR", 2, MAX_GATE_INPUTS, 2, false, true},
+    {{75, 50}, BROWN, "SPLIT", 1, 1, 1, false, false},
+    {{75, 50}, DARKBROWN, "MERGE", 2, MAX_GATE_INPUTS, 2, false, false}
 };
 
+const int GATE_TYPE_COUNT = (int)(sizeof(GATE_DATA) / sizeof(GATE_DATA[0]));
+static_assert(GATE_TYPE_COUNT == (int)GateType::MERGE + 1, "GATE_DATA must describe every GateType");
+
+// Descriptor of a gate type, resolved at compile time for constant types
+static constexpr const GateInfo& GetGateInfo(GateType type) {
+    return GATE_DATA[(int)type];
+}
+
+// Four-valued signal level. The two bits are the two bit-planes of the
+// packed encoding: bit 0 = the signal may be 1, bit 1 = it may be 0
+enum class Logic : unsigned char {
+    Z = 0, ONE = 1, ZERO = 2, X = 3
+};
+
+// X-propagation tables, indexed by Logic. A gate pin reads Z (an undriven
+// net) as X; a controlling value decides the output even next to X
+constexpr Logic LOGIC_AND[4][4] = {
+    //  Z         ONE       ZERO         X
+    { Logic::X, Logic::X, Logic::ZERO, Logic::X },          // Z
+    { Logic::X, Logic::ONE, Logic::ZERO, Logic::X },        // ONE
+    { Logic::ZERO, Logic::ZERO, Logic::ZERO, Logic::ZERO }, // ZERO
+    { Logic::X, Logic::X, Logic::ZERO, Logic::X }           // X
+};
+constexpr Logic LOGIC_OR[4][4] = {
+    //  Z         ONE         ZERO       X
+    { Logic::X, Logic::ONE, Logic::X, Logic::X },           // Z
+    { Logic::ONE, Logic::ONE, Logic::ONE, Logic::ONE },     // ONE
+    { Logic::X, Logic::ONE, Logic::ZERO, Logic::X },        // ZERO
+    { Logic::X, Logic::ONE, Logic::X, Logic::X }            // X
+};
+constexpr Logic LOGIC_NOT[4] = { Logic::X, Logic::ZERO, Logic::ONE, Logic::X };
+constexpr Logic LOGIC_BUF[4] = { Logic::X, Logic::ONE, Logic::ZERO, Logic::X };
+
+// Output level of a logic gate type (INPUT .. NOR) for two pin levels
+// (single-pin types read a); bus SPLIT / MERGE gates only move bits
+constexpr Logic EvaluateLogic(GateType type, Logic a, Logic b) {
+    if (type == GateType::INPUT) return a;
+    const GateInfo& info = GetGateInfo(type);
+    Logic reduced = info.maxInputs == 1 ? LOGIC_BUF[(int)a] : (info.andReduce ? LOGIC_AND : LOGIC_OR)[(int)a][(int)b];
+    return info.inverting ? LOGIC_NOT[(int)reduced] : reduced;
+}
+
 // CONNECTION POINT HELPER
 // ================================
 struct ConnectionPoint {
     Vector2 position;
     bool isInput;
     int gateIndex;
-    int inputIndex;  // For input points: 0 or 1, for output: always 0
+    int inputIndex;  // For input points: 0 .. inputCount-1, for output: always 0
 
     ConnectionPoint(Vector2 pos, bool input, int gate, int idx = 0)
         : position(pos), isInput(input), gateIndex(gate), inputIndex(idx) {
@@ -0,0 +1,204 @@
+#include "EditHistory.h"
+#include "WiringSystem.h"
+
+// ================================
+// STRUCTURAL DELTA FACTORIES
+// ================================
+
+EditDelta EditDelta::Place(int gateIndex, const Gate& gate) {
+    return { EditKind::PLACE, gate.GetType(), (uint8_t)gate.GetInputCount(), (uint8_t)gate.GetWidth(),
+        (uint8_t)gate.GetSliceOffset(), 0, gateIndex, -1, -1, gate.position, gate.position };
+}
+
+EditDelta EditDelta::Move(int gate, Vector2 from, Vector2 to) {
+    return { EditKind::MOVE, GateType::INPUT, 0, 1, 0, 0, gate, -1, -1, from, to };
+}
+
+EditDelta EditDelta::Remove(int gateIndex, const Gate& gate) {
+    uint64_t state = gate.GetType() == GateType::INPUT ? gate.GetSwitchValue() : 0;
+    return { EditKind::REMOVE, gate.GetType(), (uint8_t)gate.GetInputCount(), (uint8_t)gate.GetWidth(),
+        (uint8_t)gate.GetSliceOffset(), state, gateIndex, -1, -1, gate.position, gate.position };
+}
+
+EditDelta EditDelta::Connect(int fromGate, int toGate, int toInput) {
+    return { EditKind::CONNECT, GateType::INPUT, 0, 1, 0, 0, fromGate, toGate, toInput, { 0, 0 }, { 0, 0 } };
+}
+
+EditDelta EditDelta::Disconnect(int fromGate, int toGate, int toInput) {
+    return { EditKind::DISCONNECT, GateType::INPUT, 0, 1, 0, 0, fromGate, toGate, toInput, { 0, 0 }, { 0, 0 } };
+}
+
+// ================================
+// EDIT HISTORY CLASS IMPLEMENTATION
+// ================================
+
+// Constructor
+EditHistory::EditHistory(size_t memoryLimitBytes) : memoryLimit(memoryLimitBytes) {
+}
+
+// Open an undo step (steps may nest; only the outermost one counts)
+void EditHistory::BeginStep() {
+    if (replaying) return;
+    if (openDepth++ == 0) {
+        openCount = 0;
+    }
+}
+
+// Close an undo step
+void EditHistory::EndStep() {
+    if (replaying || openDepth == 0) return;
+    if (--openDepth == 0 && openCount > 0) {
+        undoSteps.push_back(openCount);
+        openCount = 0;
+        Trim();
+    }
+}
+
+// Append a delta to the journal
+void EditHistory::Record(const EditDelta& delta) {
+    if (replaying) return;
+
+    // Any new edit invalidates the redo branch
+    redoDeltas.clear();
+    redoSteps.clear();
+
+    // Coalesce a drag: keep the original start, update the end position
+    if (delta.kind == EditKind::MOVE && openDepth > 0 && openCount > 0) {
+        EditDelta& last = undoDeltas.back();
+        if (last.kind == EditKind::MOVE && last.gate == delta.gate) {
+            last.to = delta.to;
+            return;
+        }
+    }
+
+    undoDeltas.push_back(delta);
+    if (openDepth > 0) {
+        openCount++;
+    }
+    else {
+        undoSteps.push_back(1);
+        Trim();
+    }
+}
+
+// Revert the most recent step
+bool EditHistory::Undo(std::vector<std::unique_ptr<Gate>>& gates, WiringSystem& wiring) {
+    if (openDepth > 0 || undoSteps.empty()) return false;
+
+    uint32_t count = undoSteps.back();
+    undoSteps.pop_back();
+
+    replaying = true;
+    size_t first = undoDeltas.size() - count;
+    for (size_t i = undoDeltas.size(); i-- > first;) {
+        Apply(undoDeltas[i], true, gates, wiring);
+    }
+    replaying = false;
+
+    // Move the step to the redo stack, keeping forward order
+    redoDeltas.insert(redoDeltas.end(), undoDeltas.begin() + first, undoDeltas.end());
+    undoDeltas.erase(undoDeltas.begin() + first, undoDeltas.end());
+    redoSteps.push_back(count);
+    return true;
+}
+
+// Reapply the most recently undone step
+bool EditHistory::Redo(std::vector<std::unique_ptr<Gate>>& gates, WiringSystem& wiring) {
+    if (openDepth > 0 || redoSteps.empty()) return false;
+
+    uint32_t count = redoSteps.back();
+    redoSteps.pop_back();
+
+    replaying = true;
+    size_t first = redoDeltas.size() - count;
+    for (size_t i = first; i < redoDeltas.size(); i++) {
+        Apply(redoDeltas[i], false, gates, wiring);
+    }
+    replaying = false;
+
+    undoDeltas.insert(undoDeltas.end(), redoDeltas.begin() + first, redoDeltas.end());
+    redoDeltas.erase(redoDeltas.begin() + first, redoDeltas.end());
+    undoSteps.push_back(count);
+    return true;
+}
+
+bool EditHistory::CanUndo() const {
+    return openDepth == 0 && !undoSteps.empty();
+}
+
+bool EditHistory::CanRedo() const {
+    return openDepth == 0 && !redoSteps.empty();
+}
+
+void EditHistory::Clear() {
+    undoDeltas.clear();
+    undoSteps.clear();
+    redoDeltas.clear();
+    redoSteps.clear();
+    openDepth = 0;
+    openCount = 0;
+}
+
+// Memory accounting
+void EditHistory::SetMemoryLimit(size_t bytes) {
+    memoryLimit = bytes;
+    Trim();
+}
+
+size_t EditHistory::GetMemoryUsage() const {
+    return (undoDeltas.size() + redoDeltas.size()) * sizeof(EditDelta) +
+        (undoSteps.size() + redoSteps.size()) * sizeof(uint32_t);
+}
+
+// Drop the oldest steps until the journal fits its memory cap
+void EditHistory::Trim() {
+    // Never drop deltas that belong to a step that is still open
+    size_t closedDeltas = undoDeltas.size() - openCount;
+
+    while (!undoSteps.empty() && GetMemoryUsage() > memoryLimit) {
+        uint32_t count = undoSteps.front();
+        if (count > closedDeltas) break;
+
+        undoSteps.pop_front();
+        undoDeltas.erase(undoDeltas.begin(), undoDeltas.begin() + count);
+        closedDeltas -= count;
+    }
+}
+
+// Apply one delta forwards or backwards
+void EditHistory::Apply(const EditDelta& delta, bool inverse, std::vector<std::unique_ptr<Gate>>& gates, WiringSystem& wiring) {
+    bool creates = false;
+
+    switch (delta.kind) {
+    case EditKind::MOVE:
+        wiring.MoveGate(delta.gate, inverse ? delta.from : delta.to, gates);
+        return;
+    case EditKind::PLACE:
+    case EditKind::CONNECT:
+        creates = !inverse;
+        break;
+    case EditKind::REMOVE:
+    case EditKind::DISCONNECT:
+        creates = inverse;
+        break;
+    }
+
+    if (delta.kind == EditKind::PLACE || delta.kind == EditKind::REMOVE) {
+        if (creates) {
+            auto gate = std::make_unique<Gate>(delta.gateType, delta.from, delta.inputCount, delta.width, delta.sliceOffset);
+            if (delta.gateType == GateType::INPUT) gate->SetSwitchValue(delta.inputState);
+            wiring.InsertGate(delta.gate, std::move(gate), gates);
+        }
+        else {
+            wiring.RemoveGate(delta.gate, gates);
+        }
+    }
+    else {
+        if (creates) {
+            wiring.ConnectWire(delta.gate, delta.toGate, delta.toInput, gates);
+        }
+        else {
+            wiring.DisconnectWire(wiring.GetFaninWire(delta.toGate, delta.toInput));
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+#ifndef EDIT_HISTORY_H
+#define EDIT_HISTORY_H
+
+#include "raylib.h"
+#include "Constants.h"
+#include "Gate.h"
+#include <vector>
+#include <deque>
+#include <memory>
+#include <cstdint>
+
+// Forward declaration to avoid circular dependency
+class WiringSystem;
+
+// ================================
+// STRUCTURAL DELTA
+// ================================
+enum class EditKind : uint8_t {
+    PLACE, MOVE, REMOVE, CONNECT, DISCONNECT
+};
+
+// One structural change. Gate indices are valid for the circuit state the
+// delta was recorded in, which is exactly the state it is replayed against.
+struct EditDelta {
+    EditKind kind;
+    GateType gateType;      // PLACE / REMOVE
+    uint8_t inputCount;     // PLACE / REMOVE: pin count of the gate
+    uint8_t width;          // PLACE / REMOVE: bus width of the gate
+    uint8_t sliceOffset;    // PLACE / REMOVE: first bit taken by a SPLIT
+    uint64_t inputState;    // REMOVE: switch value of an INPUT gate
+    int gate;               // PLACE / MOVE / REMOVE: gate index, CONNECT / DISCONNECT: source gate
+    int toGate;             // CONNECT / DISCONNECT
+    int toInput;            // CONNECT / DISCONNECT
+    Vector2 from;           // MOVE: old position, PLACE / REMOVE: position
+    Vector2 to;             // MOVE: new position
+
+    static EditDelta Place(int gateIndex, const Gate& gate);
+    static EditDelta Move(int gate, Vector2 from, Vector2 to);
+    static EditDelta Remove(int gateIndex, const Gate& gate);
+    static EditDelta Connect(int fromGate, int toGate, int toInput);
+    static EditDelta Disconnect(int fromGate, int toGate, int toInput);
+};
+
+// ================================
+// EDIT HISTORY CLASS DECLARATION
+// ================================
+// Undo/redo journal of structural deltas. Deltas recorded between BeginStep()
+// and EndStep() form one undo step; consecutive moves of the same gate inside a
+// step are coalesced, so a long drag costs a single delta.
+class EditHistory {
+private:
+    std::deque<EditDelta> undoDeltas;
+    std::deque<uint32_t> undoSteps;     // Delta count of each undo step, oldest first
+    std::vector<EditDelta> redoDeltas;
+    std::vector<uint32_t> redoSteps;
+
+    size_t memoryLimit;
+    int openDepth = 0;
+    uint32_t openCount = 0;
+    bool replaying = false;
+
+    // Apply one delta forwards or backwards
+    void Apply(const EditDelta& delta, bool inverse, std::vector<std::unique_ptr<Gate>>& gates, WiringSystem& wiring);
+
+    // Drop the oldest steps until the journal fits its memory cap
+    void Trim();
+
+public:
+    // Constructor
+    explicit EditHistory(size_t memoryLimitBytes = HISTORY_MEMORY_LIMIT);
+
+    // Group the deltas recorded until the matching EndStep() into one undo step
+    void BeginStep();
+    void EndStep();
+
+    // Append a delta (ignored while an undo/redo is being replayed)
+    void Record(const EditDelta& delta);
+
+    // Revert / reapply the most recent step; O(size of the step)
+    bool Undo(std::vector<std::unique_ptr<Gate>>& gates, WiringSystem& wiring);
+    bool Redo(std::vector<std::unique_ptr<Gate>>& gates, WiringSystem& wiring);
+
+    bool CanUndo() const;
+    bool CanRedo() const;
+    void Clear();
+
+    // Memory accounting
+    void SetMemoryLimit(size_t bytes);
+    size_t GetMemoryUsage() const;
+};
+
+#endif // EDIT_HISTORY_H
\ No newline at end of file
@@ -0,0 +1,82 @@
+#include "EvaluationPool.h"
+#include <algorithm>
+
+// ================================
+// EVALUATION POOL CLASS IMPLEMENTATION
+// ================================
+
+// Start threads - 1 workers; the caller of Run() is worker 0
+EvaluationPool::EvaluationPool(int threads) : pending(0), arrived(0), barrierGeneration(0) {
+    if (threads <= 0) threads = (int)std::max(1u, std::thread::hardware_concurrency());
+    threadCount = threads;
+    workers.reserve(threads - 1);
+    for (int t = 1; t < threads; t++) {
+        workers.emplace_back(&EvaluationPool::WorkerLoop, this, t);
+    }
+}
+
+EvaluationPool::~EvaluationPool() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) worker.join();
+}
+
+int EvaluationPool::GetThreadCount() const {
+    return threadCount;
+}
+
+// Publish the task, take part as worker 0, then wait for the others
+void EvaluationPool::Run(void (*task)(void* context, int worker), void* context) {
+    if (threadCount > 1) {
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            runTask = task;
+            runContext = context;
+            pending.store(threadCount - 1, std::memory_order_relaxed);
+            runGeneration++;
+        }
+        wake.notify_all();
+    }
+
+    task(context, 0);
+
+    for (int spin = 0; pending.load(std::memory_order_acquire) != 0; spin++) {
+        if (spin >= SPIN_LIMIT) std::this_thread::yield();
+    }
+}
+
+// The last thread to arrive resets the count and releases the others
+void EvaluationPool::Barrier() {
+    if (threadCount == 1) return;
+    unsigned generation = barrierGeneration.load(std::memory_order_acquire);
+    if (arrived.fetch_add(1, std::memory_order_acq_rel) + 1 == threadCount) {
+        arrived.store(0, std::memory_order_relaxed);
+        barrierGeneration.fetch_add(1, std::memory_order_release);
+        return;
+    }
+    for (int spin = 0; barrierGeneration.load(std::memory_order_acquire) == generation; spin++) {
+        if (spin >= SPIN_LIMIT) std::this_thread::yield();
+    }
+}
+
+// Worker thread: sleep until a run is published, take part, repeat
+void EvaluationPool::WorkerLoop(int worker) {
+    uint64_t seen = 0;
+    for (;;) {
+        void (*task)(void*, int);
+        void* context;
+        {
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            wake.wait(lock, [&] { return stopping || runGeneration != seen; });
+            if (stopping) return;
+            seen = runGeneration;
+            task = runTask;
+            context = runContext;
+        }
+        task(context, worker);
+        pending.fetch_sub(1, std::memory_order_release);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+#ifndef EVALUATION_POOL_H
+#define EVALUATION_POOL_H
+
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+
+// ================================
+// EVALUATION POOL CLASS DECLARATION
+// ================================
+// Persistent worker threads for evaluating the wide levels of a LogicGraph.
+// Run() hands one task to every worker, the calling thread being worker 0,
+// and returns once all of them have finished it. Inside the task, Barrier()
+// separates levels: it spins on two atomics and only yields after a while,
+// so a level boundary costs well under a microsecond. Between runs the
+// workers sleep on a condition variable.
+class EvaluationPool {
+public:
+    // threads = 0 uses every core; the caller counts as one of them
+    explicit EvaluationPool(int threads = 0);
+    ~EvaluationPool();
+
+    EvaluationPool(const EvaluationPool&) = delete;
+    EvaluationPool& operator=(const EvaluationPool&) = delete;
+
+    int GetThreadCount() const;
+
+    // Run task(context, worker) on every worker; returns when all have finished
+    void Run(void (*task)(void* context, int worker), void* context);
+
+    // Wait until every worker of the current Run() has reached this point
+    void Barrier();
+
+private:
+    static const int SPIN_LIMIT = 4096;     // Spins before a waiting thread starts yielding
+
+    int threadCount;
+    std::vector<std::thread> workers;
+
+    // Current run, published under wakeMutex by bumping runGeneration
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    uint64_t runGeneration = 0;
+    bool stopping = false;
+    void (*runTask)(void*, int) = nullptr;
+    void* runContext = nullptr;
+    std::atomic<int> pending;               // Workers still inside the current run
+
+    // Level barrier: the last thread to arrive bumps the generation the
+    // others are waiting on
+    std::atomic<int> arrived;
+    std::atomic<unsigned> barrierGeneration;
+
+    // Worker thread: sleep until a run is published, take part, repeat
+    void WorkerLoop(int worker);
+};
+
+#endif // EVALUATION_POOL_H
\ No newline at end of file
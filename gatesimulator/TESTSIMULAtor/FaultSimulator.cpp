@@ -0,0 +1,257 @@
+#include "FaultSimulator.h"
+#include <thread>
+#include <chrono>
+#include <algorithm>
+
+// ================================
+// FAULT SIMULATOR CLASS IMPLEMENTATION
+// ================================
+
+double FaultSimulator::Report::Coverage() const {
+    return totalFaults ? 100.0 * detected / totalFaults : 100.0;
+}
+
+// Constructor: enumerate faults and precompute the fanout cone structure
+FaultSimulator::FaultSimulator(const LogicGraph& g) : graph(g) {
+    int count = graph.NodeCount();
+
+    for (int gate = 0; gate < (int)graph.gateNode.size(); gate++) {
+        int n = graph.gateNode[gate];
+        if (n < 0) continue;
+
+        faults.push_back({ gate, -1, false });
+        faults.push_back({ gate, -1, true });
+        for (int pin = 0; pin < graph.faninStart[n + 1] - graph.faninStart[n]; pin++) {
+            faults.push_back({ gate, pin, false });
+            faults.push_back({ gate, pin, true });
+        }
+    }
+
+    // Levels follow the evaluation order. All nodes of a loop share one level,
+    // above every node feeding the loop, so events never run backwards
+    level.assign(count, 0);
+    loopSlot.assign(count, -1);
+    for (int i = 0; i < (int)graph.order.size(); i++) {
+        int n = graph.order[i];
+        int loop = graph.loopOf[n];
+        if (loop < 0) {
+            for (int k = graph.faninStart[n]; k < graph.faninStart[n + 1]; k++) {
+                level[n] = std::max(level[n], level[graph.fanin[k]] + 1);
+            }
+            maxLevel = std::max(maxLevel, level[n]);
+            continue;
+        }
+
+        const LogicGraph::Loop& span = graph.loops[loop];
+        int top = 0;
+        for (int j = span.begin; j < span.end; j++) {
+            int m = graph.order[j];
+            for (int k = graph.faninStart[m]; k < graph.faninStart[m + 1]; k++) {
+                if (graph.loopOf[graph.fanin[k]] != loop) top = std::max(top, level[graph.fanin[k]] + 1);
+            }
+        }
+        for (int j = span.begin; j < span.end; j++) {
+            int m = graph.order[j];
+            level[m] = top;
+            loopSlot[m] = (int)loopNodes.size();
+            loopNodes.push_back(m);
+        }
+        maxLevel = std::max(maxLevel, top);
+        i = span.end - 1;
+    }
+
+    fanoutStart.assign(count + 1, 0);
+    for (int f : graph.fanin) fanoutStart[f + 1]++;
+    for (int n = 0; n < count; n++) fanoutStart[n + 1] += fanoutStart[n];
+    fanout.resize(graph.fanin.size());
+    std::vector<int> cursor(fanoutStart.begin(), fanoutStart.end() - 1);
+    for (int n = 0; n < count; n++) {
+        for (int k = graph.faninStart[n]; k < graph.faninStart[n + 1]; k++) {
+            fanout[cursor[graph.fanin[k]]++] = n;
+        }
+    }
+
+    isOutput.assign(count, 0);
+    for (int n : graph.outputs) isOutput[n] = 1;
+}
+
+const std::vector<FaultSimulator::Fault>& FaultSimulator::GetFaults() const {
+    return faults;
+}
+
+// Grade one test vector set
+FaultSimulator::Report FaultSimulator::Grade(const PatternSet& patterns, int threads) const {
+    auto start = std::chrono::steady_clock::now();
+
+    Report report;
+    report.patterns = patterns.GetPatternCount();
+    report.totalFaults = (int)faults.size();
+    report.firstDetection.assign(faults.size(), -1);
+
+    if (threads <= 0) threads = (int)std::max(1u, std::thread::hardware_concurrency());
+    threads = std::max(1, std::min(threads, (int)faults.size()));
+
+    // Interleaved slices spread deep and shallow cones evenly; each worker
+    // writes only its own entries of firstDetection
+    std::vector<std::thread> workers;
+    for (int t = 1; t < threads; t++) {
+        workers.emplace_back(&FaultSimulator::GradeSlice, this, std::cref(patterns), t, threads,
+            std::ref(report.firstDetection));
+    }
+    GradeSlice(patterns, 0, threads, report.firstDetection);
+    for (auto& worker : workers) worker.join();
+
+    report.detected = (int)std::count_if(report.firstDetection.begin(), report.firstDetection.end(),
+        [](int p) { return p >= 0; });
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return report;
+}
+
+// Grade faults first, first + stride, ... for every pattern block
+void FaultSimulator::GradeSlice(const PatternSet& patterns, int first, int stride, std::vector<int>& firstDetection) const {
+    int count = graph.NodeCount();
+    int loopCount = (int)loopNodes.size();
+    std::vector<uint64_t> good(count, 0);
+    std::vector<uint64_t> value(count, 0);
+    std::vector<unsigned char> scheduled(count, 0);
+    std::vector<std::vector<int>> buckets(maxLevel + 1);
+    std::vector<int> changed;
+
+    std::vector<int> active;
+    for (int f = first; f < (int)faults.size(); f += stride) active.push_back(f);
+
+    // Loop node values at the start of the block: of the good machine, and of
+    // the machine of every active fault (loopCount words each)
+    std::vector<uint64_t> goodState(loopCount, 0);
+    std::vector<uint64_t> faultyState(active.size() * loopCount, 0);
+
+    for (int block = 0; block < patterns.GetBlockCount() && !active.empty(); block++) {
+        uint64_t laneMask = patterns.GetLaneMask(block);
+
+        // Good-circuit simulation for this block
+        for (int i = 0; i < loopCount; i++) goodState[i] = good[loopNodes[i]];
+        for (size_t i = 0; i < graph.inputs.size(); i++) {
+            good[graph.inputs[i]] = (int)i < patterns.GetInputCount() ? patterns.Word(block, (int)i) : 0;
+        }
+        graph.Evaluate(good.data());
+        value = good;
+
+        size_t kept = 0;
+        for (size_t a = 0; a < active.size(); a++) {
+            const Fault& fault = faults[active[a]];
+            int site = graph.gateNode[fault.gate];
+            uint64_t stuck = fault.stuckAt ? ~0ull : 0;
+            uint64_t* state = faultyState.data() + a * loopCount;
+            uint64_t detectedLanes = 0;
+
+            // A loop is scheduled through its first node
+            int lowest = maxLevel + 1;
+            int highest = -1;
+            auto schedule = [&](int n) {
+                int loop = graph.loopOf[n];
+                if (loop >= 0) n = graph.order[graph.loops[loop].begin];
+                if (scheduled[n]) return;
+                scheduled[n] = 1;
+                buckets[level[n]].push_back(n);
+                lowest = std::min(lowest, level[n]);
+                highest = std::max(highest, level[n]);
+            };
+            auto fanoutChanged = [&](int n) {
+                for (int k = fanoutStart[n]; k < fanoutStart[n + 1]; k++) {
+                    if (level[fanout[k]] > level[n]) schedule(fanout[k]);
+                }
+            };
+
+            // The site is evaluated in level order like any other node, so it
+            // reads the faulty values of everything upstream of it
+            schedule(site);
+
+            // Loops whose faulty state has drifted from the good one
+            for (int i = 0; i < loopCount; i++) {
+                if (state[i] != goodState[i]) schedule(loopNodes[i]);
+            }
+
+            // Event-driven propagation through the fanout cone, level by level
+            for (int l = lowest; l <= highest; l++) {
+                for (size_t b = 0; b < buckets[l].size(); b++) {
+                    int n = buckets[l][b];
+                    scheduled[n] = 0;
+
+                    int loop = graph.loopOf[n];
+                    if (loop >= 0) {
+                        const LogicGraph::Loop& span = graph.loops[loop];
+                        SettleFaultyLoop(span, value.data(), state, fault, site, stuck);
+                        for (int j = span.begin; j < span.end; j++) {
+                            int m = graph.order[j];
+                            changed.push_back(m);
+                            if (value[m] == good[m]) continue;
+                            if (isOutput[m]) detectedLanes |= (value[m] ^ good[m]) & laneMask;
+                            fanoutChanged(m);
+                        }
+                        continue;
+                    }
+
+                    // The site keeps its fault however often it is reached
+                    uint64_t next;
+                    if (n == site) next = fault.pin < 0 ? stuck : graph.EvaluateNodeWithPin(site, value.data(), fault.pin, stuck);
+                    else next = graph.EvaluateNode(n, value.data());
+                    if (next == value[n]) continue;
+
+                    value[n] = next;
+                    changed.push_back(n);
+                    if (isOutput[n]) detectedLanes |= (next ^ good[n]) & laneMask;
+                    fanoutChanged(n);
+                }
+                buckets[l].clear();
+            }
+
+            // Keep the loop state of this fault's machine, then restore the
+            // good values touched by it
+            for (int i = 0; i < loopCount; i++) state[i] = value[loopNodes[i]];
+            for (int n : changed) value[n] = good[n];
+            changed.clear();
+
+            if (detectedLanes) {
+                firstDetection[active[a]] = block * 64 + LowestBit(detectedLanes);
+            }
+            else {
+                // Fault dropping: keep only undetected faults, with their loop state
+                std::copy(state, state + loopCount, faultyState.data() + kept * loopCount);
+                active[kept++] = active[a];
+            }
+        }
+        active.resize(kept);
+    }
+}
+
+// Settle a loop of the faulty machine from its state at the start of the
+// block, as LogicGraph::SettleLoop does for the good machine
+void FaultSimulator::SettleFaultyLoop(const LogicGraph::Loop& loop, uint64_t* values, const uint64_t* state,
+    const Fault& fault, int site, uint64_t stuck) const {
+    for (int i = loop.begin; i < loop.end; i++) {
+        int n = graph.order[i];
+        values[n] = n == site && fault.pin < 0 ? stuck : state[loopSlot[n]];
+    }
+
+    for (int pass = 0; pass < MAX_LOOP_ITERATIONS; pass++) {
+        bool moved = false;
+        for (int i = loop.begin; i < loop.end; i++) {
+            int n = graph.order[i];
+            if (n == site && fault.pin < 0) continue;
+            uint64_t next = n == site ? graph.EvaluateNodeWithPin(n, values, fault.pin, stuck) : graph.EvaluateNode(n, values);
+            if (next != values[n]) {
+                values[n] = next;
+                moved = true;
+            }
+        }
+        if (!moved) return;
+    }
+}
+
+// Human-readable fault name
+std::string FaultSimulator::Describe(const Fault& fault) const {
+    std::string name = "G" + std::to_string(fault.gate);
+    name += fault.pin < 0 ? ".out" : ".in" + std::to_string(fault.pin);
+    name += fault.stuckAt ? " SA1" : " SA0";
+    return name;
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+#ifndef FAULT_SIMULATOR_H
+#define FAULT_SIMULATOR_H
+
+#include "LogicGraph.h"
+#include "PatternSet.h"
+#include <vector>
+#include <string>
+#include <cstdint>
+
+// ================================
+// FAULT SIMULATOR CLASS DECLARATION
+// ================================
+// Stuck-at-0/1 fault grading on every gate output and input pin.
+//
+// Parallel-pattern single-fault propagation: the good circuit is simulated
+// for 64 patterns at once, then each still-undetected fault is injected and
+// propagated event by event through its fanout cone only. A fault is dropped
+// as soon as any OUTPUT differs. The fault list is interleaved across one
+// worker thread per core.
+//
+// Loops follow the semantics of LogicGraph::Evaluate: a loop reached by the
+// event front is settled again, to a fixpoint, on the faulty values. Every
+// fault keeps the state of the loop nodes in its own machine from one
+// pattern block to the next, and a loop whose faulty state differs from the
+// good one is settled even if no event reaches it.
+class FaultSimulator {
+public:
+    struct Fault {
+        int gate;           // Visible gate index
+        int pin;            // Input pin, or -1 for the gate output
+        bool stuckAt;       // Stuck-at value
+    };
+
+    struct Report {
+        int patterns = 0;
+        int totalFaults = 0;
+        int detected = 0;
+        double seconds = 0.0;
+        std::vector<int> firstDetection;    // Per fault: first detecting pattern, -1 if undetected
+
+        double Coverage() const;
+    };
+
+    // graph must be built from the visible gates (not optimized)
+    explicit FaultSimulator(const LogicGraph& graph);
+
+    const std::vector<Fault>& GetFaults() const;
+
+    // Grade one test vector set; threads = 0 uses every core
+    Report Grade(const PatternSet& patterns, int threads = 0) const;
+
+    // Human-readable fault name, e.g. "G12.in2 SA0"
+    std::string Describe(const Fault& fault) const;
+
+private:
+    const LogicGraph& graph;
+    std::vector<Fault> faults;
+    std::vector<int> level;
+    std::vector<int> fanoutStart;
+    std::vector<int> fanout;
+    std::vector<unsigned char> isOutput;
+    std::vector<int> loopNodes;     // Nodes of every loop, in evaluation order
+    std::vector<int> loopSlot;      // Node -> index in loopNodes, -1 if not on a loop
+    int maxLevel = 0;
+
+    // Grade faults first, first + stride, ... for every pattern block
+    void GradeSlice(const PatternSet& patterns, int first, int stride, std::vector<int>& firstDetection) const;
+
+    // Settle a loop of the faulty machine from its state at the start of the
+    // block (state[] is indexed by loopSlot), with the fault applied if it sits
+    // on the loop
+    void SettleFaultyLoop(const LogicGraph::Loop& loop, uint64_t* values, const uint64_t* state,
+        const Fault& fault, int site, uint64_t stuck) const;
+};
+
+#endif // FAULT_SIMULATOR_H
\ No newline at end of file
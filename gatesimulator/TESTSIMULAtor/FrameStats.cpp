@@ -0,0 +1,70 @@
+#include "FrameStats.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+
+const double FRAME_BUDGET_MS = 1000.0 / 60.0;
+
+// Nearest-rank percentile of sorted values
+double Percentile(const std::vector<double>& sorted, double fraction) {
+    size_t rank = (size_t)(fraction * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(rank, sorted.size() - 1)];
+}
+
+} // namespace
+
+// ================================
+// FRAME STATS CLASS IMPLEMENTATION
+// ================================
+
+// Keep room for this many frames so timing does not allocate
+void FrameStats::Reserve(size_t frames) {
+    frameMs.reserve(frames);
+}
+
+void FrameStats::BeginFrame() {
+    frameStart = std::chrono::steady_clock::now();
+}
+
+void FrameStats::EndFrame() {
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - frameStart;
+    frameMs.push_back(elapsed.count());
+}
+
+// Mean, percentiles and the frames over budget
+FrameStats::Summary FrameStats::Summarize() const {
+    Summary summary;
+    summary.frames = frameMs.size();
+    if (frameMs.empty()) return summary;
+
+    std::vector<double> sorted = frameMs;
+    std::sort(sorted.begin(), sorted.end());
+    for (double ms : sorted) {
+        summary.totalSeconds += ms / 1000.0;
+        if (ms > FRAME_BUDGET_MS) summary.slowFrames++;
+    }
+    summary.meanMs = summary.totalSeconds * 1000.0 / sorted.size();
+    summary.p50Ms = Percentile(sorted, 0.50);
+    summary.p90Ms = Percentile(sorted, 0.90);
+    summary.p99Ms = Percentile(sorted, 0.99);
+    summary.maxMs = sorted.back();
+    return summary;
+}
+
+// One line per figure, for the console or a report file
+std::string FrameStats::Format(const Summary& summary) {
+    char text[512];
+    std::snprintf(text, sizeof(text),
+        "frames       %zu\n"
+        "total        %.3f s\n"
+        "mean         %.3f ms\n"
+        "p50          %.3f ms\n"
+        "p90          %.3f ms\n"
+        "p99          %.3f ms\n"
+        "max          %.3f ms\n"
+        "over 16.7 ms %zu\n",
+        summary.frames, summary.totalSeconds, summary.meanMs,
+        summary.p50Ms, summary.p90Ms, summary.p99Ms, summary.maxMs, summary.slowFrames);
+    return text;
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+#ifndef FRAME_STATS_H
+#define FRAME_STATS_H
+
+#include <vector>
+#include <string>
+#include <chrono>
+
+// ================================
+// FRAME STATS CLASS DECLARATION
+// ================================
+// Frame-time distribution of a run of the main loop: every frame time is
+// kept (in a buffer reserved up front) and summarized as percentiles once
+// the run is over.
+class FrameStats {
+public:
+    struct Summary {
+        size_t frames = 0;
+        double totalSeconds = 0.0;
+        double meanMs = 0.0;
+        double p50Ms = 0.0;
+        double p90Ms = 0.0;
+        double p99Ms = 0.0;
+        double maxMs = 0.0;
+        size_t slowFrames = 0;          // Frames over the 60 FPS budget
+    };
+
+    // Keep room for this many frames so timing does not allocate
+    void Reserve(size_t frames);
+
+    // Bracket one frame
+    void BeginFrame();
+    void EndFrame();
+
+    Summary Summarize() const;
+
+    // One line per figure, for the console or a report file
+    static std::string Format(const Summary& summary);
+
+private:
+    std::vector<double> frameMs;
+    std::chrono::steady_clock::time_point frameStart;
+};
+
+#endif // FRAME_STATS_H
\ No newline at end of file
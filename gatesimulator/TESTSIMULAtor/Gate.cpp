@@ -1,13 +1,42 @@
 #include "Gate.h"
 #include <iostream>
+#include <algorithm>
 
 // ================================
 // GATE CLASS IMPLEMENTATION
 // ================================
 
 // Constructor
-Gate::Gate(GateType t, Vector2 pos) : type(t), position(pos) {
-    info = GATE_DATA.at(t);
+Gate::Gate(GateType t, Vector2 pos, int count, int bits, int offset) : type(t), position(pos) {
+    info = GetGateInfo(t);
+    inputCount = ClampInputCount(t, count == 0 ? DefaultInputCount(t) : count);
+    sliceOffset = ClampSliceOffset(t, offset);
+    width = ClampWidth(t, bits, sliceOffset);
+    inputs.assign(inputCount > 0 ? inputCount : 1, 0);
+    inputLevels.assign(inputs.size(), Logic::Z);
+
+    // Wide gates grow vertically so their pins stay INPUT_PIN_SPACING apart
+    info.size.y = std::max(info.size.y, (inputCount + 1) * INPUT_PIN_SPACING);
+}
+
+// Valid pin count for a type
+int Gate::DefaultInputCount(GateType t) {
+    return GetGateInfo(t).defaultInputs;
+}
+
+int Gate::ClampInputCount(GateType t, int requested) {
+    const GateInfo& gateInfo = GetGateInfo(t);
+    return std::min(std::max(requested, gateInfo.minInputs), gateInfo.maxInputs);
+}
+
+// Valid bus width and slice offset for a type: only a SPLIT takes an offset,
+// a MERGE is at least 2 bits wide, and a slice ends by bit 63
+int Gate::ClampSliceOffset(GateType t, int requested) {
+    return t == GateType::SPLIT ? std::min(std::max(requested, 0), MAX_BUS_WIDTH - 1) : 0;
+}
+
+int Gate::ClampWidth(GateType t, int requested, int sliceOffset) {
+    return std::min(std::max(requested, t == GateType::MERGE ? 2 : 1), MAX_BUS_WIDTH - sliceOffset);
 }
 
 // Getters
@@ -27,29 +56,28 @@ const char* Gate::GetLabel() const {
     return info.label;
 }
 
-// Logic computation
-void Gate::ComputeOutput() {
-    switch (type) {
-    case GateType::INPUT:
-    case GateType::OUTPUT:
-        output = input1;
-        break;
-    case GateType::AND:
-        output = input1 && input2;
-        break;
-    case GateType::OR:
-        output = input1 || input2;
-        break;
-    case GateType::NOT:
-        output = !input1;
-        break;
-    case GateType::NAND:
-        output = !(input1 && input2);
-        break;
-    case GateType::NOR:
-        output = !(input1 || input2);
-        break;
-    }
+int Gate::GetWidth() const {
+    return width;
+}
+
+int Gate::GetSliceOffset() const {
+    return sliceOffset;
+}
+
+bool Gate::IsBus() const {
+    return width > 1;
+}
+
+// Switch value of an INPUT gate: 0/1, or the whole word of a bus INPUT
+uint64_t Gate::GetSwitchValue() const {
+    return width > 1 ? busValue : inputs[0];
+}
+
+// Set the switch of an INPUT gate; bits beyond the width are dropped
+void Gate::SetSwitchValue(uint64_t value) {
+    value &= BusMask(width);
+    inputs[0] = value & 1;
+    if (width > 1) busValue = value;
 }
 
 // Collision and boundary methods
@@ -72,8 +100,8 @@ Vector2 Gate::GetInputPoint(int inputIndex) const {
         return { position.x - 8, position.y + info.size.y * 0.5f };
     }
 
-    // For other gates, use the original offset logic
-    float offsetY = (inputIndex == 0) ? info.size.y * 0.33f : info.size.y * 0.66f;
+    // For other gates, spread the pins evenly (1/3 and 2/3 of the height for two inputs)
+    float offsetY = info.size.y * (inputIndex + 1) / (inputCount + 1);
     return { position.x - 8, position.y + offsetY };
 }
 
@@ -82,32 +110,18 @@ Vector2 Gate::GetOutputPoint() const {
 }
 
 int Gate::GetInputCount() const {
-    switch (type) {
-    case GateType::INPUT:
-        return 0;  // No inputs
-    case GateType::OUTPUT:
-    case GateType::NOT:
-        return 1;  // Single input
-    case GateType::AND:
-    case GateType::OR:
-    case GateType::NAND:
-    case GateType::NOR:
-        return 2;  // Two inputs
-    default:
-        return 0;
-    }
+    return inputCount;
 }
 
 bool Gate::HasOutput() const {
     return type != GateType::OUTPUT;  // All gates except OUTPUT have outputs
 }
 
-// Get all connection points for this gate
-std::vector<ConnectionPoint> Gate::GetConnectionPoints(int gateIndex) const {
-    std::vector<ConnectionPoint> points;
+// Fill points with all connection points of this gate; the caller's buffer keeps its capacity
+void Gate::GetConnectionPoints(int gateIndex, std::vector<ConnectionPoint>& points) const {
+    points.clear();
 
     // Add input points
-    int inputCount = GetInputCount();
     for (int i = 0; i < inputCount; i++) {
         points.emplace_back(GetInputPoint(i), true, gateIndex, i);
     }
@@ -116,66 +130,79 @@ std::vector<ConnectionPoint> Gate::GetConnectionPoints(int gateIndex) const {
     if (HasOutput()) {
         points.emplace_back(GetOutputPoint(), false, gateIndex, 0);
     }
-
-    return points;
 }
 
-// Check if an input is connected
-bool Gate::IsInputConnected(int inputIndex, const std::vector<std::unique_ptr<Wire>>& wires) const {
-    for (const auto& wire : wires) {
-        if (wire->toInputIndex == inputIndex) {
-            return true;
-        }
-    }
-    return false;
-}
-
-// Private method for drawing connection points
-void Gate::DrawConnectionPoints() const {
+// Private method for drawing connection points: red = 1, dark gray = 0,
+// orange = X, hollow = Z (nothing drives the pin)
+void Gate::DrawConnectionPoints(GeometryBatch& shapes) const {
     // Draw input points
-    int inputCount = GetInputCount();
     for (int i = 0; i < inputCount; i++) {
-        Vector2 inputPos = GetInputPoint(i);
-        bool inputState = (i == 0) ? input1 : input2;
-
-        // Draw input circle
-        DrawCircleV(inputPos, CONNECTION_POINT_RADIUS, WHITE);
-        DrawCircleV(inputPos, CONNECTION_POINT_RADIUS - 1, inputState ? RED : DARKGRAY);
-        DrawCircleLinesV(inputPos, CONNECTION_POINT_RADIUS, BLACK);
+        DrawConnectionPoint(shapes, GetInputPoint(i), inputLevels[i]);
     }
 
     // Draw output point
     if (HasOutput()) {
-        Vector2 outputPos = GetOutputPoint();
+        DrawConnectionPoint(shapes, GetOutputPoint(), outputLevel);
+    }
+}
 
-        // Draw output circle
-        DrawCircleV(outputPos, CONNECTION_POINT_RADIUS, WHITE);
-        DrawCircleV(outputPos, CONNECTION_POINT_RADIUS - 1, output ? RED : DARKGRAY);
-        DrawCircleLinesV(outputPos, CONNECTION_POINT_RADIUS, BLACK);
+// One connection point in the colour of its level
+void Gate::DrawConnectionPoint(GeometryBatch& shapes, Vector2 center, Logic level) {
+    // Black rim, white ring, then the level
+    shapes.AddCircle(center, CONNECTION_POINT_RADIUS + 0.5f, BLACK);
+    shapes.AddCircle(center, CONNECTION_POINT_RADIUS - 0.5f, WHITE);
+    if (level != Logic::Z) {
+        Color fill = level == Logic::ONE ? RED : level == Logic::ZERO ? DARKGRAY : ORANGE;
+        shapes.AddCircle(center, CONNECTION_POINT_RADIUS - 1, fill);
     }
 }
 
-// Rendering
-void Gate::Draw(bool preview, bool highlight) const {
+// Body, outline and pins, into the shape batch of the frame
+void Gate::Draw(GeometryBatch& shapes, bool preview, bool highlight) const {
     Rectangle body = GetBounds();
     Color drawColor = info.color;
 
     if (preview) drawColor.a = 128; // Semi-transparent for preview
     if (highlight) drawColor = ColorBrightness(drawColor, 0.3f); // Brighter when highlighted
 
-    DrawRectangleRec(body, drawColor);
-    DrawRectangleLinesEx(body, highlight ? 3 : 2, highlight ? YELLOW : BLACK);
+    shapes.AddRectangle(body, drawColor);
+    shapes.AddRectangleLines(body, highlight ? 3 : 2, highlight ? YELLOW : BLACK);
 
+    // Oscillating loop marker
+    if (oscillating && !preview) {
+        shapes.AddRectangleLines({ body.x - 4, body.y - 4, body.width + 8, body.height + 8 }, 2, ORANGE);
+    }
+
+    // Draw connection points (only if not preview)
+    if (!preview) {
+        DrawConnectionPoints(shapes);
+    }
+}
+
+// Text of the gate: its label, or the value of an INPUT or OUTPUT
+void Gate::DrawLabels(bool preview) const {
+    // Bus INPUT and OUTPUT gates show their word in hex
+    if (!preview && width > 1 && (type == GateType::INPUT || type == GateType::OUTPUT)) {
+        const char* valueText = outputLevel == Logic::X ? "X" : TextFormat("%llX", (unsigned long long)busValue);
+        int fontSize = 14;
+        int valueWidth = MeasureText(valueText, fontSize);
+        Vector2 valuePos = {
+            position.x + (info.size.x - valueWidth) / 2,
+            position.y + (info.size.y - fontSize) / 2
+        };
+        DrawText(valueText, valuePos.x, valuePos.y, fontSize, outputLevel == Logic::X ? ORANGE : LIME);
+    }
     // For INPUT and OUTPUT gates, show digital state instead of label when placed
-    if (!preview && (type == GateType::INPUT || type == GateType::OUTPUT)) {
-        const char* stateText = output ? "1" : "0";
+    else if (!preview && (type == GateType::INPUT || type == GateType::OUTPUT)) {
+        const char* stateText = outputLevel == Logic::ONE ? "1" : outputLevel == Logic::ZERO ? "0" : "X";
         int fontSize = 24;
         int stateWidth = MeasureText(stateText, fontSize);
         Vector2 statePos = {
             position.x + (info.size.x - stateWidth) / 2,
             position.y + (info.size.y - fontSize) / 2
         };
-        DrawText(stateText, statePos.x, statePos.y, fontSize, output ? LIME : RED);
+        Color stateColor = outputLevel == Logic::ONE ? LIME : outputLevel == Logic::ZERO ? RED : ORANGE;
+        DrawText(stateText, statePos.x, statePos.y, fontSize, stateColor);
     }
     else {
         // Show gate label for all other gates or when in preview mode
@@ -188,8 +215,9 @@ void Gate::Draw(bool preview, bool highlight) const {
         DrawText(info.label, textPos.x, textPos.y, fontSize, WHITE);
     }
 
-    // Draw connection points (only if not preview)
-    if (!preview) {
-        DrawConnectionPoints();
+    // Bit range of a bus gate under its body
+    if (width > 1 || type == GateType::SPLIT) {
+        const char* rangeText = TextFormat("[%i:%i]", sliceOffset + width - 1, sliceOffset);
+        DrawText(rangeText, position.x + 2, position.y + info.size.y + 2, 10, DARKGRAY);
     }
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "raymath.h"
 #include "Constants.h"
 #include "Wire.h"
+#include "GeometryBatch.h"
 #include <vector>
 #include <memory>
 
@@ -15,26 +16,54 @@ class Gate {
 private:
     GateType type;
     GateInfo info;
-    void DrawConnectionPoints() const;
+    int inputCount;
+    int width;                  // Bits on the output: 1, or a bus of up to MAX_BUS_WIDTH
+    int sliceOffset;            // SPLIT only: first bit of the input taken
+    void DrawConnectionPoints(GeometryBatch& shapes) const;
+    static void DrawConnectionPoint(GeometryBatch& shapes, Vector2 center, Logic level);
 
 public:
     // Gate properties
     Vector2 position;
-    bool input1 = false;
-    bool input2 = false;
+    // Contiguous fanin values, one per input pin. An INPUT gate has no pins and
+    // keeps its switch state in inputs[0] (bit 0 of it for a bus INPUT).
+    std::vector<unsigned char> inputs;
     bool output = false;
+    // All output bits of a bus gate (bit 0 of a 1-bit gate), and the switch
+    // word of a bus INPUT; output and outputLevel then tell whether it is nonzero
+    uint64_t busValue = 0;
+    // Four-valued view of the same signals, kept by every evaluation: 0/1 in
+    // two-valued mode, X for a gate not evaluated yet, Z on a pin with no wire
+    std::vector<Logic> inputLevels;
+    Logic outputLevel = Logic::X;
+    bool oscillating = false;   // Sits on a combinational loop that did not settle
 
-    // Constructor
-    Gate(GateType t, Vector2 pos);
+    // Constructor (inputCount 0 = default for the type; clamped to what the type allows).
+    // A width above 1 makes the bitwise bus variant of the type; a SPLIT
+    // passes `width` bits of its input on, starting at bit sliceOffset, and
+    // a MERGE (always a bus) packs its pins into `width` bits
+    Gate(GateType t, Vector2 pos, int inputCount = 0, int width = 1, int sliceOffset = 0);
+
+    // Valid pin count for a type
+    static int DefaultInputCount(GateType t);
+    static int ClampInputCount(GateType t, int requested);
+
+    // Valid slice offset and bus width for a type
+    static int ClampSliceOffset(GateType t, int requested);
+    static int ClampWidth(GateType t, int requested, int sliceOffset);
 
     // Getters
     GateType GetType() const;
     Vector2 GetSize() const;
     Color GetColor() const;
     const char* GetLabel() const;
+    int GetWidth() const;
+    int GetSliceOffset() const;
+    bool IsBus() const;
 
-    // Logic computation
-    void ComputeOutput();
+    // Switch value of an INPUT gate: 0/1, or the whole word of a bus INPUT
+    uint64_t GetSwitchValue() const;
+    void SetSwitchValue(uint64_t value);
 
     // Collision and boundary methods
     Rectangle GetBounds() const;
@@ -47,14 +76,13 @@ public:
     int GetInputCount() const;
     bool HasOutput() const;
 
-    // Get all connection points for this gate
-    std::vector<ConnectionPoint> GetConnectionPoints(int gateIndex) const;
-
-    // Check if an input is connected
-    bool IsInputConnected(int inputIndex, const std::vector<std::unique_ptr<Wire>>& wires) const;
+    // Fill points (a buffer the caller reuses) with all connection points of this gate
+    void GetConnectionPoints(int gateIndex, std::vector<ConnectionPoint>& points) const;
 
-    // Rendering
-    void Draw(bool preview = false, bool highlight = false) const;
+    // Rendering: body and pins go into the frame's shape batch, the text is
+    // drawn over them once the batch has been submitted
+    void Draw(GeometryBatch& shapes, bool preview = false, bool highlight = false) const;
+    void DrawLabels(bool preview = false) const;
 };
 
 #endif // GATE_H
\ No newline at end of file
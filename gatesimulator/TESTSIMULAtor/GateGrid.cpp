@@ -0,0 +1,82 @@
+#include "GateGrid.h"
+#include "Gate.h"
+#include <cmath>
+
+// ================================
+// GATE GRID CLASS IMPLEMENTATION
+// ================================
+
+// Constructor
+GateGrid::GateGrid(float cellSize) : cellSize(cellSize) {
+}
+
+// File a gate under every cell its bounds touch
+void GateGrid::Insert(const Gate* gate) {
+    int x0, y0, x1, y1;
+    CellRange(gate->GetBounds(), x0, y0, x1, y1);
+
+    std::vector<Location>& placed = locations[gate];
+    for (int y = y0; y <= y1; y++) {
+        for (int x = x0; x <= x1; x++) {
+            std::vector<Entry>& entries = cells[Key(x, y)];
+            placed.push_back({ &entries, entries.size() });
+            entries.push_back({ gate, (int)placed.size() - 1 });
+        }
+    }
+}
+
+// Unfile a gate: each entry is overwritten by the last one of its cell,
+// whose handle then follows it
+void GateGrid::Remove(const Gate* gate) {
+    auto found = locations.find(gate);
+    if (found == locations.end()) return;
+
+    for (const Location& location : found->second) {
+        std::vector<Entry>& entries = *location.cell;
+        const Entry moved = entries.back();
+        entries.pop_back();
+        if (location.index < entries.size()) {
+            entries[location.index] = moved;
+            locations[moved.gate][moved.handle].index = location.index;
+        }
+    }
+    // The emptied list keeps its capacity, so refiling a moved gate does not allocate
+    found->second.clear();
+}
+
+// Drop every entry
+void GateGrid::Clear() {
+    cells.clear();
+    locations.clear();
+}
+
+// True if a gate other than skipA / skipB overlaps the area
+bool GateGrid::Overlaps(Rectangle area, const Gate* skipA, const Gate* skipB) const {
+    int x0, y0, x1, y1;
+    CellRange(area, x0, y0, x1, y1);
+
+    for (int y = y0; y <= y1; y++) {
+        for (int x = x0; x <= x1; x++) {
+            auto cell = cells.find(Key(x, y));
+            if (cell == cells.end()) continue;
+
+            for (const Entry& entry : cell->second) {
+                if (entry.gate == skipA || entry.gate == skipB) continue;
+                if (CheckCollisionRecs(area, entry.gate->GetBounds())) return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Range of cells covered by a rectangle
+void GateGrid::CellRange(Rectangle area, int& x0, int& y0, int& x1, int& y1) const {
+    x0 = (int)std::floor(area.x / cellSize);
+    y0 = (int)std::floor(area.y / cellSize);
+    x1 = (int)std::floor((area.x + area.width) / cellSize);
+    y1 = (int)std::floor((area.y + area.height) / cellSize);
+}
+
+uint64_t GateGrid::Key(int x, int y) {
+    return ((uint64_t)(uint32_t)x << 32) | (uint32_t)y;
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#ifndef GATE_GRID_H
+#define GATE_GRID_H
+
+#include "raylib.h"
+#include "Constants.h"
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+// Forward declaration to avoid circular dependency
+class Gate;
+
+// ================================
+// GATE GRID CLASS DECLARATION
+// ================================
+// Spatial hash of gate bounds on a uniform grid, so placement checks and the
+// wire router look at the gates near a rectangle instead of every gate. Like
+// SegmentHash, each gate keeps handles to its entries for O(1) removal; a gate
+// must be removed before it moves and inserted again afterwards.
+class GateGrid {
+public:
+    explicit GateGrid(float cellSize = GATE_GRID_CELL_SIZE);
+
+    // File / unfile a gate under its current bounds
+    void Insert(const Gate* gate);
+    void Remove(const Gate* gate);
+
+    // Drop every entry
+    void Clear();
+
+    // True if a gate other than skipA / skipB overlaps the area (same test as CheckCollisionRecs)
+    bool Overlaps(Rectangle area, const Gate* skipA = nullptr, const Gate* skipB = nullptr) const;
+
+private:
+    struct Entry {
+        const Gate* gate;
+        int handle;             // Index into the gate's list of locations
+    };
+
+    struct Location {
+        std::vector<Entry>* cell;
+        size_t index;
+    };
+
+    float cellSize;
+
+    // Cells and location lists are never erased (only emptied): Location::cell
+    // stays valid, and moving a gate every frame does not allocate
+    std::unordered_map<uint64_t, std::vector<Entry>> cells;
+    std::unordered_map<const Gate*, std::vector<Location>> locations;
+
+    // Range of cells covered by a rectangle
+    void CellRange(Rectangle area, int& x0, int& y0, int& x1, int& y1) const;
+
+    static uint64_t Key(int x, int y);
+};
+
+#endif // GATE_GRID_H
\ No newline at end of file
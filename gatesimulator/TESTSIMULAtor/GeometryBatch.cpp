@@ -0,0 +1,129 @@
+#include "GeometryBatch.h"
+#include <cmath>
+#include <utility>
+
+namespace {
+
+const int CIRCLE_SEGMENTS = 12;
+const float SMALL_CIRCLE_RADIUS = 3.0f;    // At most this radius, every other segment is used
+const int MIN_BATCH_VERTICES = 4096;
+
+// Points on the unit circle, the first repeated at the end
+struct UnitCircle {
+    Vector2 points[CIRCLE_SEGMENTS + 1];
+
+    UnitCircle() {
+        for (int i = 0; i <= CIRCLE_SEGMENTS; i++) {
+            float angle = 2.0f * PI * (i % CIRCLE_SEGMENTS) / CIRCLE_SEGMENTS;
+            points[i] = { std::cos(angle), std::sin(angle) };
+        }
+    }
+};
+
+const UnitCircle UNIT_CIRCLE;
+
+} // namespace
+
+// ================================
+// GEOMETRY BATCH CLASS IMPLEMENTATION
+// ================================
+
+// Drop the shapes of the previous frame, keeping the storage
+void GeometryBatch::Clear() {
+    vertices.clear();
+}
+
+void GeometryBatch::AddRectangle(Rectangle rect, Color color) {
+    Vector2 topLeft = { rect.x, rect.y };
+    Vector2 bottomRight = { rect.x + rect.width, rect.y + rect.height };
+    AddQuad(topLeft, { topLeft.x, bottomRight.y }, bottomRight, { bottomRight.x, topLeft.y }, color);
+}
+
+// Outline inside rect: full-width top and bottom bands, sides between them
+void GeometryBatch::AddRectangleLines(Rectangle rect, float thickness, Color color) {
+    if (thickness * 2 >= rect.width || thickness * 2 >= rect.height) {
+        AddRectangle(rect, color);
+        return;
+    }
+    float sideHeight = rect.height - 2 * thickness;
+    AddRectangle({ rect.x, rect.y, rect.width, thickness }, color);
+    AddRectangle({ rect.x, rect.y + rect.height - thickness, rect.width, thickness }, color);
+    AddRectangle({ rect.x, rect.y + thickness, thickness, sideHeight }, color);
+    AddRectangle({ rect.x + rect.width - thickness, rect.y + thickness, thickness, sideHeight }, color);
+}
+
+// Filled disc as a fan around its centre
+void GeometryBatch::AddCircle(Vector2 center, float radius, Color color) {
+    int step = radius <= SMALL_CIRCLE_RADIUS ? 2 : 1;
+    for (int i = 0; i < CIRCLE_SEGMENTS; i += step) {
+        Vector2 from = UNIT_CIRCLE.points[i];
+        Vector2 to = UNIT_CIRCLE.points[i + step];
+        AddTriangle(center,
+            { center.x + to.x * radius, center.y + to.y * radius },
+            { center.x + from.x * radius, center.y + from.y * radius }, color);
+    }
+}
+
+// Line of the given thickness centred on start-end
+void GeometryBatch::AddSegment(Vector2 start, Vector2 end, float thickness, Color color) {
+    float dx = end.x - start.x;
+    float dy = end.y - start.y;
+    float length = std::sqrt(dx * dx + dy * dy);
+    if (length == 0.0f) return;
+
+    float scale = thickness / (2.0f * length);
+    Vector2 side = { -dy * scale, dx * scale };
+    AddQuad({ start.x + side.x, start.y + side.y }, { start.x - side.x, start.y - side.y },
+        { end.x - side.x, end.y - side.y }, { end.x + side.x, end.y + side.y }, color);
+}
+
+size_t GeometryBatch::GetVertexCount() const {
+    return vertices.size();
+}
+
+// Hand the frame to an rlgl render batch of its own and draw it with one call
+void GeometryBatch::Submit() {
+    if (vertices.empty()) return;
+
+    // rlgl sizes batches in quads of 4 vertices and keeps the last one spare
+    int needed = (int)vertices.size() + 4;
+    if (needed > batchVertices) {
+        if (batchVertices > 0) rlUnloadRenderBatch(batch);
+        batchVertices = MIN_BATCH_VERTICES;
+        while (batchVertices < needed) batchVertices *= 2;
+        batch = rlLoadRenderBatch(1, batchVertices / 4);
+    }
+
+    // Switching to the batch draws what raylib had queued (the sidebar) first;
+    // switching back draws this frame's triangles
+    rlSetRenderBatchActive(&batch);
+    rlBegin(RL_TRIANGLES);
+    for (const Vertex& vertex : vertices) {
+        rlColor4ub(vertex.color.r, vertex.color.g, vertex.color.b, vertex.color.a);
+        rlVertex2f(vertex.x, vertex.y);
+    }
+    rlEnd();
+    rlSetRenderBatchActive(nullptr);
+}
+
+// Release the render batch; must run before CloseWindow()
+void GeometryBatch::Unload() {
+    if (batchVertices > 0) rlUnloadRenderBatch(batch);
+    batch = {};
+    batchVertices = 0;
+}
+
+// One triangle, turned counter-clockwise on screen (y down) so back-face
+// culling keeps it
+void GeometryBatch::AddTriangle(Vector2 a, Vector2 b, Vector2 c, Color color) {
+    float turn = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+    if (turn > 0.0f) std::swap(b, c);
+    vertices.push_back({ a.x, a.y, color });
+    vertices.push_back({ b.x, b.y, color });
+    vertices.push_back({ c.x, c.y, color });
+}
+
+void GeometryBatch::AddQuad(Vector2 a, Vector2 b, Vector2 c, Vector2 d, Color color) {
+    AddTriangle(a, b, c, color);
+    AddTriangle(a, c, d, color);
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#ifndef GEOMETRY_BATCH_H
+#define GEOMETRY_BATCH_H
+
+#include "raylib.h"
+#include "rlgl.h"
+#include <vector>
+#include <cstddef>
+
+// ================================
+// GEOMETRY BATCH CLASS DECLARATION
+// ================================
+// Flat-coloured shapes of one frame (gate bodies, pins, wire segments)
+// tessellated into a single triangle list as they are added. Every vertex
+// carries the colour of its shape, so signal state travels with the geometry
+// instead of as a raylib call per shape. Submit() draws the whole list from
+// one rlgl render batch grown to hold it: one draw call, however many gates
+// and wires the design has. Shapes appear in the order added; text is not
+// batched and is drawn after Submit(), on top.
+//
+// Both the vertex list and the render batch are kept between frames, so once
+// they have grown to the design adding and submitting do not allocate.
+class GeometryBatch {
+public:
+    // Drop the shapes of the previous frame, keeping the storage
+    void Clear();
+
+    void AddRectangle(Rectangle rect, Color color);
+
+    // Outline inside rect, as DrawRectangleLinesEx()
+    void AddRectangleLines(Rectangle rect, float thickness, Color color);
+
+    // Filled disc; small discs get fewer segments
+    void AddCircle(Vector2 center, float radius, Color color);
+
+    // Line of the given thickness centred on start-end, as DrawLineEx()
+    void AddSegment(Vector2 start, Vector2 end, float thickness, Color color);
+
+    size_t GetVertexCount() const;
+
+    // Draw everything added since Clear() in one call, between BeginDrawing()
+    // and EndDrawing(); what raylib had queued before is drawn first
+    void Submit();
+
+    // Release the render batch; must run before CloseWindow()
+    void Unload();
+
+private:
+    struct Vertex {
+        float x, y;
+        Color color;
+    };
+
+    std::vector<Vertex> vertices;       // Three per triangle
+    rlRenderBatch batch = {};
+    int batchVertices = 0;              // Room in batch; 0 before the first Submit()
+
+    // One triangle, turned counter-clockwise so back-face culling keeps it
+    void AddTriangle(Vector2 a, Vector2 b, Vector2 c, Color color);
+    void AddQuad(Vector2 a, Vector2 b, Vector2 c, Vector2 d, Color color);
+};
+
+#endif // GEOMETRY_BATCH_H
\ No newline at end of file
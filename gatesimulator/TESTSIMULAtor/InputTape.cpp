@@ -0,0 +1,231 @@
+#include "InputTape.h"
+#include <cstring>
+
+namespace {
+
+const char MAGIC[4] = { 'G', 'S', 'I', 'N' };
+const uint32_t FORMAT_VERSION = 1;
+
+struct Header {
+    char magic[4];
+    uint32_t version;
+    uint32_t circuitLength;             // Startup circuit path follows the header
+    uint32_t reserved;
+};
+
+// Keys the main loop reads, one bit each; append only
+const int RECORDED_KEYS[] = {
+    KEY_LEFT_CONTROL, KEY_RIGHT_CONTROL, KEY_LEFT_SHIFT, KEY_RIGHT_SHIFT,
+    KEY_DELETE, KEY_A, KEY_C, KEY_V, KEY_Z, KEY_Y, KEY_S,
+    KEY_EQUAL, KEY_KP_ADD, KEY_MINUS, KEY_KP_SUBTRACT,
+    KEY_F2, KEY_F3, KEY_F5, KEY_F9,
+    KEY_F4, KEY_F6, KEY_F7,
+    KEY_LEFT_BRACKET, KEY_RIGHT_BRACKET, KEY_COMMA, KEY_PERIOD,
+    KEY_F8,
+};
+const int RECORDED_KEY_COUNT = sizeof(RECORDED_KEYS) / sizeof(RECORDED_KEYS[0]);
+static_assert(RECORDED_KEY_COUNT <= 64, "key bits must fit in a uint64_t");
+
+const int MOUSE_BUTTON_COUNT = 3;       // Left, right, middle
+
+} // namespace
+
+// ================================
+// INPUT TAPE CLASS IMPLEMENTATION
+// ================================
+
+// Open the session file and write its header
+bool InputTape::StartRecording(const std::string& path, const std::string& circuitPath, std::string& error) {
+    Stop();
+    out.open(path, std::ios::binary);
+    if (!out) {
+        error = "cannot write " + path;
+        return false;
+    }
+
+    Header header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = FORMAT_VERSION;
+    header.circuitLength = (uint32_t)circuitPath.size();
+    out.write((const char*)&header, sizeof(header));
+    out.write(circuitPath.data(), circuitPath.size());
+    if (!out) {
+        error = "write failed: " + path;
+        out.close();
+        return false;
+    }
+
+    circuit = circuitPath;
+    recording = true;
+    return true;
+}
+
+// Read every frame of a session written by StartRecording()
+bool InputTape::StartReplay(const std::string& path, std::string& error) {
+    Stop();
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        error = "cannot open " + path;
+        return false;
+    }
+
+    Header header;
+    if (!in.read((char*)&header, sizeof(header)) || std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        error = path + ": not an input session";
+        return false;
+    }
+    if (header.version != FORMAT_VERSION) {
+        error = path + ": unsupported session version " + std::to_string(header.version);
+        return false;
+    }
+
+    std::string startup(header.circuitLength, '\0');
+    in.read(&startup[0], startup.size());
+
+    std::vector<Frame> frames;
+    std::vector<std::string> drops;
+    Frame next;
+    while (in.read((char*)&next, sizeof(next))) {
+        std::string dropped(next.droppedLength, '\0');
+        if (!in.read(&dropped[0], dropped.size())) break;
+        frames.push_back(next);
+        drops.push_back(dropped);
+    }
+    if (!in.eof() || in.gcount() != 0) {
+        error = path + ": truncated input session";
+        return false;
+    }
+
+    circuit.swap(startup);
+    replayFrames.swap(frames);
+    replayDrops.swap(drops);
+    replaying = true;
+    frameCount = 0;
+    return true;
+}
+
+// Flush and close the session file of a recording
+void InputTape::Stop() {
+    if (recording) {
+        out.close();
+        recording = false;
+    }
+    replaying = false;
+    frameCount = 0;
+}
+
+// Advance to the next frame; false once a replay has run out of frames
+bool InputTape::NextFrame() {
+    if (replaying) {
+        if (frameCount >= replayFrames.size()) return false;
+        frame = replayFrames[frameCount];
+        droppedFile = replayDrops[frameCount];
+        frameCount++;
+        return true;
+    }
+
+    Poll();
+    if (recording) {
+        out.write((const char*)&frame, sizeof(frame));
+        out.write(droppedFile.data(), droppedFile.size());
+        frameCount++;
+    }
+    return true;
+}
+
+bool InputTape::IsRecording() const {
+    return recording;
+}
+
+bool InputTape::IsReplaying() const {
+    return replaying;
+}
+
+size_t InputTape::GetFrameCount() const {
+    return frameCount;
+}
+
+size_t InputTape::GetReplayLength() const {
+    return replayFrames.size();
+}
+
+const std::string& InputTape::GetCircuit() const {
+    return circuit;
+}
+
+Vector2 InputTape::GetMousePosition() const {
+    return { frame.mouseX, frame.mouseY };
+}
+
+bool InputTape::IsMouseButtonPressed(int button) const {
+    return button >= 0 && button < MOUSE_BUTTON_COUNT && (frame.buttons >> (8 + button) & 1) != 0;
+}
+
+bool InputTape::IsMouseButtonDown(int button) const {
+    return button >= 0 && button < MOUSE_BUTTON_COUNT && (frame.buttons >> button & 1) != 0;
+}
+
+bool InputTape::IsMouseButtonReleased(int button) const {
+    return button >= 0 && button < MOUSE_BUTTON_COUNT && (frame.buttons >> (16 + button) & 1) != 0;
+}
+
+bool InputTape::IsKeyPressed(int key) const {
+    int bit = KeyBit(key);
+    return bit >= 0 && (frame.keysPressed >> bit & 1) != 0;
+}
+
+bool InputTape::IsKeyDown(int key) const {
+    int bit = KeyBit(key);
+    return bit >= 0 && (frame.keysDown >> bit & 1) != 0;
+}
+
+bool InputTape::IsFileDropped() const {
+    return frame.droppedLength > 0;
+}
+
+const std::string& InputTape::GetDroppedFile() const {
+    return droppedFile;
+}
+
+double InputTape::GetTime() const {
+    return frame.time;
+}
+
+// Fill the frame from raylib; the dropped path is only assigned on a drop,
+// so ordinary frames do not allocate
+void InputTape::Poll() {
+    Vector2 mouse = ::GetMousePosition();
+    frame.time = ::GetTime();
+    frame.mouseX = mouse.x;
+    frame.mouseY = mouse.y;
+
+    frame.buttons = 0;
+    for (int button = 0; button < MOUSE_BUTTON_COUNT; button++) {
+        if (::IsMouseButtonDown(button)) frame.buttons |= 1u << button;
+        if (::IsMouseButtonPressed(button)) frame.buttons |= 1u << (8 + button);
+        if (::IsMouseButtonReleased(button)) frame.buttons |= 1u << (16 + button);
+    }
+
+    frame.keysDown = 0;
+    frame.keysPressed = 0;
+    for (int bit = 0; bit < RECORDED_KEY_COUNT; bit++) {
+        if (::IsKeyDown(RECORDED_KEYS[bit])) frame.keysDown |= 1ull << bit;
+        if (::IsKeyPressed(RECORDED_KEYS[bit])) frame.keysPressed |= 1ull << bit;
+    }
+
+    droppedFile.clear();
+    if (::IsFileDropped()) {
+        FilePathList dropped = LoadDroppedFiles();
+        if (dropped.count > 0) droppedFile = dropped.paths[0];
+        UnloadDroppedFiles(dropped);
+    }
+    frame.droppedLength = (uint32_t)droppedFile.size();
+}
+
+// Bit of a recorded key, -1 if it is not recorded
+int InputTape::KeyBit(int key) {
+    for (int bit = 0; bit < RECORDED_KEY_COUNT; bit++) {
+        if (RECORDED_KEYS[bit] == key) return bit;
+    }
+    return -1;
+}
\ No newline at end of file
@@ -0,0 +1,86 @@
+#ifndef INPUT_TAPE_H
+#define INPUT_TAPE_H
+
+#include "raylib.h"
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstdint>
+
+// ================================
+// INPUT TAPE CLASS DECLARATION
+// ================================
+// Source of the per-frame input read by the main loop. Live, each frame polls
+// raylib once and may append the result to a session file; in replay the
+// frames come from such a file instead, so the loop runs exactly the code
+// paths of the recorded session. Time is part of the frame as well, which
+// makes replays independent of how fast they run.
+//
+// Only the keys listed in InputTape.cpp are recorded: a key read by the main
+// loop must be added there (at the end, so older sessions stay readable).
+class InputTape {
+public:
+    // Live input, optionally appended to a session file; circuit is the file
+    // opened at startup, stored so a replay starts from the same design
+    bool StartRecording(const std::string& path, const std::string& circuit, std::string& error);
+
+    // Read a whole session file; later frames come from it
+    bool StartReplay(const std::string& path, std::string& error);
+
+    // Flush and close the session file of a recording
+    void Stop();
+
+    // Advance to the next frame; false once a replay has run out of frames
+    bool NextFrame();
+
+    bool IsRecording() const;
+    bool IsReplaying() const;
+    size_t GetFrameCount() const;       // Recorded or replayed so far
+    size_t GetReplayLength() const;
+    const std::string& GetCircuit() const;
+
+    // Input of the current frame, as the raylib calls of the same name
+    Vector2 GetMousePosition() const;
+    bool IsMouseButtonPressed(int button) const;
+    bool IsMouseButtonDown(int button) const;
+    bool IsMouseButtonReleased(int button) const;
+    bool IsKeyPressed(int key) const;
+    bool IsKeyDown(int key) const;
+    bool IsFileDropped() const;
+    const std::string& GetDroppedFile() const;
+    double GetTime() const;
+
+private:
+    // One frame as stored in the session file; a dropped file path of
+    // droppedLength bytes follows it
+    struct Frame {
+        double time;
+        float mouseX;
+        float mouseY;
+        uint32_t buttons;               // Down bits 0-7, pressed 8-15, released 16-23
+        uint32_t droppedLength;
+        uint64_t keysDown;              // One bit per recorded key
+        uint64_t keysPressed;
+    };
+
+    Frame frame = {};
+    std::string droppedFile;
+    size_t frameCount = 0;
+
+    std::ofstream out;
+    bool recording = false;
+
+    bool replaying = false;
+    std::vector<Frame> replayFrames;
+    std::vector<std::string> replayDrops;   // Dropped file of each frame (usually empty)
+
+    std::string circuit;
+
+    // Fill the frame from raylib
+    void Poll();
+
+    // Bit of a recorded key, -1 if it is not recorded
+    static int KeyBit(int key);
+};
+
+#endif // INPUT_TAPE_H
\ No newline at end of file
@@ -0,0 +1,195 @@
+#include "LocalityOrder.h"
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+// Set-associative cache with LRU replacement, counting misses
+class CacheModel {
+public:
+    CacheModel() : sets(CACHE_MODEL_BYTES / (CACHE_LINE_BYTES * CACHE_MODEL_WAYS)),
+        tags(sets * CACHE_MODEL_WAYS, ~0ull), stamps(sets * CACHE_MODEL_WAYS, 0) {
+    }
+
+    void Access(uint64_t address) {
+        uint64_t line = address / CACHE_LINE_BYTES;
+        size_t base = (size_t)(line % sets) * CACHE_MODEL_WAYS;
+        size_t oldest = base;
+        clock++;
+        for (size_t way = base; way < base + CACHE_MODEL_WAYS; way++) {
+            if (tags[way] == line) {
+                stamps[way] = clock;
+                return;
+            }
+            if (stamps[way] < stamps[oldest]) oldest = way;
+        }
+        tags[oldest] = line;
+        stamps[oldest] = clock;
+        misses++;
+    }
+
+    uint64_t misses = 0;
+
+private:
+    size_t sets;
+    std::vector<uint64_t> tags;
+    std::vector<uint64_t> stamps;
+    uint64_t clock = 0;
+};
+
+// Accesses of one node evaluation: its fanin range, each fanin index and
+// word, then the node word itself
+void AccessNode(const LogicGraph& graph, int n, uint64_t faninStartBase, uint64_t faninBase, CacheModel& cache,
+    uint64_t& accesses) {
+    cache.Access(faninStartBase + 4 * (uint64_t)n);
+    cache.Access(faninStartBase + 4 * (uint64_t)(n + 1));
+    accesses += 3;
+    for (int k = graph.faninStart[n]; k < graph.faninStart[n + 1]; k++) {
+        cache.Access(faninBase + 4 * (uint64_t)k);
+        cache.Access(8 * (uint64_t)graph.fanin[k]);
+        accesses += 2;
+    }
+    cache.Access(8 * (uint64_t)n);
+}
+
+// First address past an array, rounded up to a whole line
+uint64_t LineEnd(uint64_t base, uint64_t bytes) {
+    return (base + bytes + CACHE_LINE_BYTES - 1) / CACHE_LINE_BYTES * CACHE_LINE_BYTES;
+}
+
+} // namespace
+
+// ================================
+// LOCALITY ORDER IMPLEMENTATION
+// ================================
+
+// Number the nodes in evaluation order and rebuild every array of the graph
+void LocalityOrder::Apply(LogicGraph& graph, Stats* statsOut) {
+    Stats stats;
+    stats.nodes = graph.NodeCount();
+    stats.missesBefore = ModelMisses(graph);
+
+    int count = graph.NodeCount();
+    std::vector<int> renumber(count, -1);
+    int next = 0;
+    renumber[LogicGraph::CONST0_NODE] = next++;
+    renumber[LogicGraph::CONST1_NODE] = next++;
+    for (int n : graph.inputs) renumber[n] = next++;
+
+    // Kernels keep their fanin-count order; ties go to the node whose first
+    // fanin comes first, so neighbours read neighbouring words
+    auto firstFanin = [&](int n) {
+        int first = count;
+        for (int k = graph.faninStart[n]; k < graph.faninStart[n + 1]; k++) {
+            first = std::min(first, renumber[graph.fanin[k]] < 0 ? count : renumber[graph.fanin[k]]);
+        }
+        return first;
+    };
+    std::vector<int> order;
+    order.reserve(graph.order.size());
+    int spans = (int)graph.spanKernels.size() - 1;
+    for (int l = 0; l < spans; l++) {
+        for (int k = graph.spanKernels[l]; k < graph.spanKernels[l + 1]; k++) {
+            const LogicGraph::Kernel& kernel = graph.kernels[k];
+            auto begin = graph.schedule.begin() + kernel.begin;
+            auto end = graph.schedule.begin() + kernel.end;
+            std::stable_sort(begin, end, [&](int a, int b) {
+                int widthA = graph.faninStart[a + 1] - graph.faninStart[a];
+                int widthB = graph.faninStart[b + 1] - graph.faninStart[b];
+                if (widthA != widthB) return widthA < widthB;
+                return firstFanin(a) < firstFanin(b);
+            });
+            for (auto it = begin; it != end; ++it) {
+                renumber[*it] = next++;
+                order.push_back(*it);
+            }
+        }
+        if (l == (int)graph.loops.size()) break;
+
+        const LogicGraph::Loop& loop = graph.loops[l];
+        for (int i = loop.begin; i < loop.end; i++) {
+            renumber[graph.order[i]] = next++;
+            order.push_back(graph.order[i]);
+        }
+    }
+    for (int n = 0; n < count; n++) {
+        if (renumber[n] < 0) renumber[n] = next++;      // Unused INPUT-like nodes of a hand-built graph
+    }
+
+    // Loops are ranges of order, and the new order has the same span and loop sizes
+    std::vector<int> oldOf(count);
+    for (int n = 0; n < count; n++) oldOf[renumber[n]] = n;
+
+    std::vector<NodeOp> ops(count);
+    std::vector<uint8_t> widths(count);
+    std::vector<uint8_t> shifts(count);
+    std::vector<int> loopOf(count);
+    std::vector<int> faninStart(1, 0);
+    std::vector<int> fanin;
+    faninStart.reserve(count + 1);
+    fanin.reserve(graph.fanin.size());
+    for (int m = 0; m < count; m++) {
+        int n = oldOf[m];
+        ops[m] = graph.ops[n];
+        widths[m] = graph.widths[n];
+        shifts[m] = graph.shifts[n];
+        loopOf[m] = graph.loopOf[n];
+        for (int k = graph.faninStart[n]; k < graph.faninStart[n + 1]; k++) fanin.push_back(renumber[graph.fanin[k]]);
+        faninStart.push_back((int)fanin.size());
+    }
+
+    auto remap = [&](std::vector<int>& nodes) {
+        for (int& n : nodes) {
+            if (n >= 0) n = renumber[n];
+        }
+    };
+    for (int& n : order) n = renumber[n];
+    remap(graph.schedule);
+    remap(graph.inputs);
+    remap(graph.outputs);
+    remap(graph.gateNode);
+
+    graph.ops.swap(ops);
+    graph.widths.swap(widths);
+    graph.shifts.swap(shifts);
+    graph.loopOf.swap(loopOf);
+    graph.faninStart.swap(faninStart);
+    graph.fanin.swap(fanin);
+    graph.order.swap(order);
+
+    stats.missesAfter = ModelMisses(graph, &stats.accesses);
+    if (statsOut) *statsOut = stats;
+}
+
+// Replay two evaluations through the cache model and count the misses of the second
+uint64_t LocalityOrder::ModelMisses(const LogicGraph& graph, uint64_t* accessesOut) {
+    uint64_t faninStartBase = LineEnd(0, 8 * (uint64_t)graph.NodeCount());
+    uint64_t faninBase = LineEnd(faninStartBase, 4 * (uint64_t)graph.faninStart.size());
+
+    CacheModel cache;
+    uint64_t accesses = 0;
+    for (int pass = 0; pass < 2; pass++) {
+        if (pass == 1) {
+            cache.misses = 0;
+            accesses = 0;
+        }
+        for (int n : graph.inputs) {
+            cache.Access(8 * (uint64_t)n);
+            accesses++;
+        }
+        int spans = (int)graph.spanKernels.size() - 1;
+        for (int l = 0; l < spans; l++) {
+            for (int k = graph.spanKernels[l]; k < graph.spanKernels[l + 1]; k++) {
+                for (int i = graph.kernels[k].begin; i < graph.kernels[k].end; i++) {
+                    AccessNode(graph, graph.schedule[i], faninStartBase, faninBase, cache, accesses);
+                }
+            }
+            if (l == (int)graph.loops.size()) break;
+            for (int i = graph.loops[l].begin; i < graph.loops[l].end; i++) {
+                AccessNode(graph, graph.order[i], faninStartBase, faninBase, cache, accesses);
+            }
+        }
+    }
+    if (accessesOut) *accessesOut = accesses;
+    return cache.misses;
+}
\ No newline at end of file
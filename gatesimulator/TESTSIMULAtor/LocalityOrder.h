@@ -0,0 +1,35 @@
+#ifndef LOCALITY_ORDER_H
+#define LOCALITY_ORDER_H
+
+#include "LogicGraph.h"
+#include <cstdint>
+
+// ================================
+// LOCALITY ORDER CLASS DECLARATION
+// ================================
+// Renumbers the nodes of a LogicGraph in the order they are evaluated:
+// constants, INPUTs, then every kernel and loop in turn. Node words are then
+// written front to back and fanin lists are read in the same direction,
+// instead of following the order gates were placed in. Inside a kernel,
+// nodes reading neighbouring words are put side by side. The structure is
+// unchanged: gateNode, inputs and outputs are renumbered with the nodes.
+//
+// The report replays the memory accesses of one evaluation (node words,
+// faninStart and fanin) through a model of a CACHE_MODEL_BYTES set-associative
+// LRU cache, warm, before and after the pass.
+class LocalityOrder {
+public:
+    struct Stats {
+        int nodes = 0;
+        uint64_t accesses = 0;          // Memory accesses of one evaluation
+        uint64_t missesBefore = 0;      // Modelled cache misses of one warm evaluation
+        uint64_t missesAfter = 0;
+    };
+
+    static void Apply(LogicGraph& graph, Stats* stats = nullptr);
+
+    // Modelled misses of one evaluation after a warm-up evaluation
+    static uint64_t ModelMisses(const LogicGraph& graph, uint64_t* accesses = nullptr);
+};
+
+#endif // LOCALITY_ORDER_H
\ No newline at end of file
@@ -0,0 +1,708 @@
+#include "LogicGraph.h"
+#include "WiringSystem.h"
+#include "EvaluationPool.h"
+#include <algorithm>
+
+namespace {
+
+// Node operation of each GateType (OUTPUT gates are buffers)
+const NodeOp GATE_NODE_OP[GATE_TYPE_COUNT] = {
+    NodeOp::INPUT, NodeOp::BUF, NodeOp::AND, NodeOp::OR, NodeOp::NOT, NodeOp::NAND, NodeOp::NOR,
+    NodeOp::SLICE, NodeOp::MERGE
+};
+
+// Evaluate a run of nodes that share one operation. Op is a compile-time
+// constant, so the loop body has no branch on the node type: BUF and NOT
+// have a single fanin and skip the reduction loop.
+template<NodeOp Op>
+void EvaluateRun(const int* nodes, int count, const int* faninStart, const int* fanin, uint64_t* values) {
+    const bool andReduce = (Op == NodeOp::AND || Op == NodeOp::NAND);
+    const uint64_t invert = (Op == NodeOp::NOT || Op == NodeOp::NAND || Op == NodeOp::NOR) ? ~0ull : 0;
+
+    for (int k = 0; k < count; k++) {
+        int n = nodes[k];
+        const int* in = fanin + faninStart[n];
+        const int* end = fanin + faninStart[n + 1];
+        uint64_t acc = values[*in++];
+        if (andReduce) {
+            while (in < end) acc &= values[*in++];
+        }
+        else {
+            while (in < end) acc |= values[*in++];
+        }
+        values[n] = acc ^ invert;
+    }
+}
+
+// Four-valued form of EvaluateRun over interleaved bit-planes: planes[2n] is
+// "may be 1", planes[2n + 1] "may be 0" (see Logic). AND-type nodes AND the
+// high planes and OR the low planes, OR-type nodes the other way round, and
+// inverting nodes swap the two, so X propagates with two operations per pin.
+// Pins never read Z: the undriven node holds X (see Evaluate4).
+template<NodeOp Op>
+void EvaluateRun4(const int* nodes, int count, const int* faninStart, const int* fanin, uint64_t* planes) {
+    const bool andReduce = (Op == NodeOp::AND || Op == NodeOp::NAND);
+    const bool invert = (Op == NodeOp::NOT || Op == NodeOp::NAND || Op == NodeOp::NOR);
+
+    for (int k = 0; k < count; k++) {
+        int n = nodes[k];
+        const int* in = fanin + faninStart[n];
+        const int* end = fanin + faninStart[n + 1];
+        uint64_t high = planes[2 * *in];
+        uint64_t low = planes[2 * *in + 1];
+        in++;
+        if (andReduce) {
+            for (; in < end; in++) {
+                high &= planes[2 * *in];
+                low |= planes[2 * *in + 1];
+            }
+        }
+        else {
+            for (; in < end; in++) {
+                high |= planes[2 * *in];
+                low &= planes[2 * *in + 1];
+            }
+        }
+        planes[2 * n] = invert ? low : high;
+        planes[2 * n + 1] = invert ? high : low;
+    }
+}
+
+// The plane operations above on one lane, for a gate with pins a and b
+// (single-pin types read a)
+constexpr Logic PlaneLogic(GateType type, Logic a, Logic b) {
+    const GateInfo& info = GetGateInfo(type);
+    int x = (int)a;
+    int y = (int)b;
+    int reduced = info.maxInputs == 1 ? x
+        : info.andReduce ? (x & y & 1) | ((x | y) & 2)
+        : ((x | y) & 1) | (x & y & 2);
+    return (Logic)(info.inverting ? (reduced >> 1) | ((reduced & 1) << 1) : reduced);
+}
+
+// Check the plane operations against the X-propagation tables for the levels
+// a pin can carry (0, 1, X), and that the tables read Z as X
+constexpr bool PlanesMatchTables() {
+    const Logic levels[3] = { Logic::ZERO, Logic::ONE, Logic::X };
+    for (int t = 1; t <= (int)GateType::NOR; t++) {     // INPUT has no pins
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 3; j++) {
+                if (PlaneLogic((GateType)t, levels[i], levels[j]) != EvaluateLogic((GateType)t, levels[i], levels[j])) return false;
+            }
+            if (EvaluateLogic((GateType)t, Logic::Z, levels[i]) != EvaluateLogic((GateType)t, Logic::X, levels[i])) return false;
+        }
+    }
+    return true;
+}
+static_assert(PlanesMatchTables(), "four-valued kernels disagree with the X-propagation tables");
+
+// Arguments of a parallel evaluation, shared by every worker
+struct ParallelEvaluation {
+    const LogicGraph* graph;
+    uint64_t* words;
+    unsigned char* unstable;
+    bool fourValued;
+    EvaluationPool* pool;
+};
+
+void EvaluateShareTask(void* context, int worker) {
+    ParallelEvaluation& run = *(ParallelEvaluation*)context;
+    run.graph->EvaluateShare(run.words, run.unstable, run.fourValued, *run.pool, worker);
+}
+
+// Node words of a chunk edge fill whole 64-byte lines (nodes are numbered in
+// schedule order, see LocalityOrder), so no two threads write the same line
+const int CHUNK_ALIGN = 8;
+
+} // namespace
+
+// ================================
+// LOGIC GRAPH IMPLEMENTATION
+// ================================
+
+// Compile the visible circuit; node n + 2 is gate n
+void LogicGraph::Build(const std::vector<std::unique_ptr<Gate>>& gates, const WiringSystem& wiring) {
+    ops.clear();
+    faninStart.assign(1, 0);
+    fanin.clear();
+    inputs.clear();
+    outputs.clear();
+    widths.clear();
+    shifts.clear();
+    gateNode.assign(gates.size(), -1);
+    hasBuses = false;
+
+    AddNode(NodeOp::CONST0, nullptr, 0);
+    AddNode(NodeOp::CONST1, nullptr, 0);
+
+    std::vector<int> pins;
+    for (int g = 0; g < (int)gates.size(); g++) {
+        const Gate& gate = *gates[g];
+
+        pins.clear();
+        for (int i = 0; i < gate.GetInputCount(); i++) {
+            Wire* wire = wiring.GetFaninWire(g, i);
+            pins.push_back(wire ? wire->fromGateIndex + 2 : (int)CONST0_NODE);
+        }
+
+        NodeOp op = GATE_NODE_OP[(int)gate.GetType()];
+        gateNode[g] = AddNode(op, pins.data(), (int)pins.size());
+        widths.back() = (uint8_t)gate.GetWidth();
+        shifts.back() = (uint8_t)gate.GetSliceOffset();
+        hasBuses |= gate.IsBus() || op == NodeOp::SLICE || op == NodeOp::MERGE;
+        if (op == NodeOp::INPUT) inputs.push_back(gateNode[g]);
+        if (gate.GetType() == GateType::OUTPUT) outputs.push_back(gateNode[g]);
+    }
+
+    Levelize();
+}
+
+// Append a node
+int LogicGraph::AddNode(NodeOp op, const int* faninNodes, int count) {
+    if (faninStart.empty()) faninStart.push_back(0);
+    ops.push_back(op);
+    widths.push_back(1);
+    shifts.push_back(0);
+    fanin.insert(fanin.end(), faninNodes, faninNodes + count);
+    faninStart.push_back((int)fanin.size());
+    return (int)ops.size() - 1;
+}
+
+int LogicGraph::NodeCount() const {
+    return (int)ops.size();
+}
+
+// Recompute the evaluation order (Tarjan's strongly connected components,
+// iterative). The search follows fanin edges, so every component is emitted
+// after the components it reads from: emission order is evaluation order.
+void LogicGraph::Levelize() {
+    int count = NodeCount();
+    std::vector<int> index(count, -1);
+    std::vector<int> low(count, 0);
+    std::vector<unsigned char> onStack(count, 0);
+    std::vector<int> stack;
+    std::vector<std::pair<int, int>> path;     // (node, next fanin slot to visit)
+    int counter = 0;
+
+    order.clear();
+    loops.clear();
+    loopOf.assign(count, -1);
+
+    for (int root = 0; root < count; root++) {
+        if (index[root] != -1) continue;
+
+        index[root] = low[root] = counter++;
+        stack.push_back(root);
+        onStack[root] = 1;
+        path.push_back({ root, faninStart[root] });
+
+        while (!path.empty()) {
+            int n = path.back().first;
+            int k = path.back().second;
+
+            if (k < faninStart[n + 1]) {
+                path.back().second++;
+                int f = fanin[k];
+                if (index[f] == -1) {
+                    index[f] = low[f] = counter++;
+                    stack.push_back(f);
+                    onStack[f] = 1;
+                    path.push_back({ f, faninStart[f] });
+                }
+                else if (onStack[f]) {
+                    low[n] = std::min(low[n], index[f]);
+                }
+                continue;
+            }
+
+            path.pop_back();
+            if (!path.empty()) {
+                int parent = path.back().first;
+                low[parent] = std::min(low[parent], low[n]);
+            }
+            if (low[n] != index[n]) continue;
+
+            // n roots a component; fanins were discovered after their readers,
+            // so popping the stack lists them first
+            int begin = (int)order.size();
+            bool cyclic = stack.back() != n;
+            for (int j = faninStart[n]; j < faninStart[n + 1]; j++) {
+                if (fanin[j] == n) cyclic = true;      // Gate wired into itself
+            }
+
+            int member;
+            do {
+                member = stack.back();
+                stack.pop_back();
+                onStack[member] = 0;
+                if (ops[member] != NodeOp::CONST0 && ops[member] != NodeOp::CONST1 && ops[member] != NodeOp::INPUT) {
+                    order.push_back(member);
+                }
+                if (cyclic) loopOf[member] = (int)loops.size();
+            } while (member != n);
+
+            if (cyclic) loops.push_back({ begin, (int)order.size() });
+        }
+    }
+
+    hasCycles = !loops.empty();
+    BuildKernels();
+}
+
+// Group each acyclic span between loops into per-level, per-operation kernels.
+// Levels only count fanins computed in the same span: everything else is
+// ready before the span starts.
+void LogicGraph::BuildKernels() {
+    int count = NodeCount();
+    std::vector<int> level(count, 0);
+    std::vector<int> spanOf(count, -1);
+    std::vector<int> span;
+
+    schedule.clear();
+    kernels.clear();
+    spanKernels.assign(1, 0);
+    levels.clear();
+    spanLevels.assign(1, 0);
+    widestLevel = 0;
+
+    int i = 0;
+    for (int l = 0; l <= (int)loops.size(); l++) {
+        int stop = l < (int)loops.size() ? loops[l].begin : (int)order.size();
+        span.assign(order.begin() + i, order.begin() + stop);
+
+        for (int n : span) {
+            int depth = 0;
+            for (int k = faninStart[n]; k < faninStart[n + 1]; k++) {
+                int f = fanin[k];
+                if (spanOf[f] == l) depth = std::max(depth, level[f] + 1);
+            }
+            level[n] = depth;
+            spanOf[n] = l;
+        }
+
+        // Same-width nodes stay together so the reduction loop exits predictably
+        std::stable_sort(span.begin(), span.end(), [&](int a, int b) {
+            if (level[a] != level[b]) return level[a] < level[b];
+            if (ops[a] != ops[b]) return ops[a] < ops[b];
+            return faninStart[a + 1] - faninStart[a] < faninStart[b + 1] - faninStart[b];
+        });
+
+        for (size_t k = 0; k < span.size(); k++) {
+            int n = span[k];
+            bool newLevel = k == 0 || level[n] != level[span[k - 1]];
+            if (newLevel || ops[n] != ops[span[k - 1]]) {
+                int at = (int)schedule.size();
+                kernels.push_back({ ops[n], at, at });
+            }
+            if (newLevel) {
+                int at = (int)schedule.size();
+                levels.push_back({ (int)kernels.size() - 1, (int)kernels.size() - 1, at, at });
+            }
+            schedule.push_back(n);
+            kernels.back().end++;
+            levels.back().kernelEnd = (int)kernels.size();
+            levels.back().nodeEnd++;
+            widestLevel = std::max(widestLevel, levels.back().nodeEnd - levels.back().nodeBegin);
+        }
+        spanKernels.push_back((int)kernels.size());
+        spanLevels.push_back((int)levels.size());
+
+        if (l < (int)loops.size()) i = loops[l].end;
+    }
+}
+
+// Evaluate every node of a kernel; the switch runs once per kernel, not per node
+void LogicGraph::RunKernel(const Kernel& kernel, uint64_t* values) const {
+    RunNodes(kernel.op, kernel.begin, kernel.end, values);
+}
+
+void LogicGraph::RunNodes(NodeOp op, int begin, int end, uint64_t* values) const {
+    const int* nodes = schedule.data() + begin;
+    int count = end - begin;
+    const int* start = faninStart.data();
+    const int* in = fanin.data();
+
+    switch (op) {
+    case NodeOp::BUF: EvaluateRun<NodeOp::BUF>(nodes, count, start, in, values); break;
+    case NodeOp::NOT: EvaluateRun<NodeOp::NOT>(nodes, count, start, in, values); break;
+    case NodeOp::AND: EvaluateRun<NodeOp::AND>(nodes, count, start, in, values); break;
+    case NodeOp::OR: EvaluateRun<NodeOp::OR>(nodes, count, start, in, values); break;
+    case NodeOp::NAND: EvaluateRun<NodeOp::NAND>(nodes, count, start, in, values); break;
+    case NodeOp::NOR: EvaluateRun<NodeOp::NOR>(nodes, count, start, in, values); break;
+    case NodeOp::SLICE:
+    case NodeOp::MERGE:
+        for (int k = 0; k < count; k++) values[nodes[k]] = EvaluateNode(nodes[k], values);
+        break;
+    default: break;
+    }
+}
+
+// Evaluate all nodes: acyclic spans kernel by kernel, loops to a bounded fixpoint
+void LogicGraph::Evaluate(uint64_t* values, unsigned char* unstable, EvaluationPool* pool) const {
+    values[CONST0_NODE] = 0;
+    values[CONST1_NODE] = ~0ull;
+
+    if (pool && pool->GetThreadCount() > 1 && widestLevel >= PARALLEL_MIN_LEVEL_NODES) {
+        ParallelEvaluation run = { this, values, unstable, false, pool };
+        pool->Run(EvaluateShareTask, &run);
+        return;
+    }
+
+    int spans = (int)spanKernels.size() - 1;       // loops.size() + 1 once levelized
+    for (int l = 0; l < spans; l++) {
+        for (int k = spanKernels[l]; k < spanKernels[l + 1]; k++) {
+            RunKernel(kernels[k], values);
+        }
+        if (l == (int)loops.size()) break;
+
+        bool settled = SettleLoop(loops[l], values);
+        if (unstable) unstable[l] = !settled;
+    }
+}
+
+// One worker's share of a parallel evaluation. Every worker walks the same
+// levels and so meets the same barriers: one after each wide level, and one
+// before a wide level that follows work done by worker 0 alone
+void LogicGraph::EvaluateShare(uint64_t* words, unsigned char* unstable, bool fourValued, EvaluationPool& pool,
+    int worker) const {
+    int workers = pool.GetThreadCount();
+    bool serialPending = false;     // Worker 0 wrote nodes the others have not synchronized with
+
+    int spans = (int)spanKernels.size() - 1;
+    for (int l = 0; l < spans; l++) {
+        for (int v = spanLevels[l]; v < spanLevels[l + 1]; v++) {
+            const Level& level = levels[v];
+            int count = level.nodeEnd - level.nodeBegin;
+
+            if (count < PARALLEL_MIN_LEVEL_NODES) {
+                if (worker == 0) {
+                    for (int k = level.kernelBegin; k < level.kernelEnd; k++) {
+                        if (fourValued) RunKernel4(kernels[k], words);
+                        else RunKernel(kernels[k], words);
+                    }
+                }
+                serialPending = true;
+                continue;
+            }
+
+            if (serialPending) {
+                pool.Barrier();
+                serialPending = false;
+            }
+
+            // Static chunk of this worker, edges aligned on the node words
+            int skew = schedule[level.nodeBegin] % CHUNK_ALIGN;
+            auto edge = [&](int t) {
+                if (t == 0) return level.nodeBegin;
+                if (t == workers) return level.nodeEnd;
+                int at = (int)((long long)count * t / workers);
+                at = (at + skew + CHUNK_ALIGN / 2) / CHUNK_ALIGN * CHUNK_ALIGN - skew;
+                return level.nodeBegin + std::min(std::max(at, 0), count);
+            };
+            int begin = edge(worker);
+            int end = edge(worker + 1);
+            for (int k = level.kernelBegin; k < level.kernelEnd && begin < end; k++) {
+                int from = std::max(begin, kernels[k].begin);
+                int to = std::min(end, kernels[k].end);
+                if (from >= to) continue;
+                if (fourValued) RunNodes4(kernels[k].op, from, to, words);
+                else RunNodes(kernels[k].op, from, to, words);
+            }
+            pool.Barrier();
+        }
+        if (l == (int)loops.size()) break;
+
+        if (worker == 0) {
+            bool settled = fourValued ? SettleLoop4(loops[l], words) : SettleLoop(loops[l], words);
+            if (unstable) unstable[l] = !settled;
+        }
+        serialPending = true;
+    }
+}
+
+// Iterate one loop until no value changes; false if it is still oscillating
+bool LogicGraph::SettleLoop(const Loop& loop, uint64_t* values) const {
+    for (int pass = 0; pass < MAX_LOOP_ITERATIONS; pass++) {
+        bool changed = false;
+        for (int i = loop.begin; i < loop.end; i++) {
+            int n = order[i];
+            uint64_t next = EvaluateNode(n, values);
+            if (next != values[n]) {
+                values[n] = next;
+                changed = true;
+            }
+        }
+        if (!changed) return true;
+    }
+    return false;
+}
+
+// Value of a single node from its fanin words
+uint64_t LogicGraph::EvaluateNode(int n, const uint64_t* values) const {
+    const int* in = fanin.data() + faninStart[n];
+    int count = faninStart[n + 1] - faninStart[n];
+    uint64_t acc;
+
+    switch (ops[n]) {
+    case NodeOp::BUF:
+        return values[in[0]];
+    case NodeOp::NOT:
+        return ~values[in[0]];
+    case NodeOp::AND:
+    case NodeOp::NAND:
+        acc = ~0ull;
+        for (int i = 0; i < count; i++) acc &= values[in[i]];
+        return ops[n] == NodeOp::AND ? acc : ~acc;
+    case NodeOp::OR:
+    case NodeOp::NOR:
+        acc = 0;
+        for (int i = 0; i < count; i++) acc |= values[in[i]];
+        return ops[n] == NodeOp::OR ? acc : ~acc;
+    case NodeOp::SLICE:
+        return (values[in[0]] & BusMask(widths[in[0]])) >> shifts[n];
+    case NodeOp::MERGE:
+        return MergePins(in, count, values, 1);
+    case NodeOp::CONST1:
+        return ~0ull;
+    default:
+        return values[n];
+    }
+}
+
+// Bits of the pins of a MERGE node side by side, pin 0 lowest, each as wide
+// as its driver; bits past the 64th are dropped. stride 2 reads one plane
+// of interleaved four-valued words
+uint64_t LogicGraph::MergePins(const int* in, int count, const uint64_t* values, int stride) const {
+    uint64_t acc = 0;
+    int at = 0;
+    for (int i = 0; i < count && at < 64; i++) {
+        acc |= (values[stride * in[i]] & BusMask(widths[in[i]])) << at;
+        at += widths[in[i]];
+    }
+    return acc;
+}
+
+// Value of a single node with one pin forced (stuck-at injection)
+uint64_t LogicGraph::EvaluateNodeWithPin(int n, const uint64_t* values, int pin, uint64_t pinValue) const {
+    const int* in = fanin.data() + faninStart[n];
+    int count = faninStart[n + 1] - faninStart[n];
+    uint64_t acc;
+
+    switch (ops[n]) {
+    case NodeOp::BUF:
+        return pinValue;
+    case NodeOp::NOT:
+        return ~pinValue;
+    case NodeOp::AND:
+    case NodeOp::NAND:
+        acc = ~0ull;
+        for (int i = 0; i < count; i++) acc &= (i == pin) ? pinValue : values[in[i]];
+        return ops[n] == NodeOp::AND ? acc : ~acc;
+    case NodeOp::OR:
+    case NodeOp::NOR:
+        acc = 0;
+        for (int i = 0; i < count; i++) acc |= (i == pin) ? pinValue : values[in[i]];
+        return ops[n] == NodeOp::OR ? acc : ~acc;
+    default:
+        return EvaluateNode(n, values);
+    }
+}
+
+// Copy one pattern lane back into the visible gates and wires
+void LogicGraph::WriteBack(const uint64_t* values, int lane, std::vector<std::unique_ptr<Gate>>& gates,
+    const WiringSystem& wiring) const {
+    for (int g = 0; g < (int)gates.size(); g++) {
+        Gate& gate = *gates[g];
+        int node = gateNode[g];
+        if (gate.GetType() == GateType::INPUT) {
+            gate.busValue = gate.GetSwitchValue();
+        }
+        else if (gate.IsBus()) {
+            gate.busValue = node >= 0 ? values[node] & BusMask(gate.GetWidth()) : 0;
+        }
+        else {
+            gate.busValue = node >= 0 ? (values[node] >> lane) & 1 : 0;
+        }
+        gate.output = gate.busValue != 0;
+        gate.outputLevel = gate.output ? Logic::ONE : Logic::ZERO;
+    }
+
+    for (int g = 0; g < (int)gates.size(); g++) {
+        Gate& gate = *gates[g];
+        for (int i = 0; i < gate.GetInputCount(); i++) {
+            Wire* wire = wiring.GetFaninWire(g, i);
+            gate.inputs[i] = wire ? gates[wire->fromGateIndex]->output : 0;
+            gate.inputLevels[i] = gate.inputs[i] ? Logic::ONE : Logic::ZERO;
+            if (wire) {
+                wire->state = gate.inputs[i] != 0;
+                wire->level = gate.inputLevels[i];
+                wire->busValue = gates[wire->fromGateIndex]->busValue;
+            }
+        }
+    }
+}
+
+// Evaluate every node of a kernel over both planes
+void LogicGraph::RunKernel4(const Kernel& kernel, uint64_t* planes) const {
+    RunNodes4(kernel.op, kernel.begin, kernel.end, planes);
+}
+
+void LogicGraph::RunNodes4(NodeOp op, int begin, int end, uint64_t* planes) const {
+    const int* nodes = schedule.data() + begin;
+    int count = end - begin;
+    const int* start = faninStart.data();
+    const int* in = fanin.data();
+
+    switch (op) {
+    case NodeOp::BUF: EvaluateRun4<NodeOp::BUF>(nodes, count, start, in, planes); break;
+    case NodeOp::NOT: EvaluateRun4<NodeOp::NOT>(nodes, count, start, in, planes); break;
+    case NodeOp::AND: EvaluateRun4<NodeOp::AND>(nodes, count, start, in, planes); break;
+    case NodeOp::OR: EvaluateRun4<NodeOp::OR>(nodes, count, start, in, planes); break;
+    case NodeOp::NAND: EvaluateRun4<NodeOp::NAND>(nodes, count, start, in, planes); break;
+    case NodeOp::NOR: EvaluateRun4<NodeOp::NOR>(nodes, count, start, in, planes); break;
+    case NodeOp::SLICE:
+    case NodeOp::MERGE:
+        for (int k = 0; k < count; k++) {
+            int n = nodes[k];
+            EvaluateNode4(n, planes, planes[2 * n], planes[2 * n + 1]);
+        }
+        break;
+    default: break;
+    }
+}
+
+// Evaluate all nodes four-valued; the undriven (CONST0) node reads X
+void LogicGraph::Evaluate4(uint64_t* planes, unsigned char* unstable, EvaluationPool* pool) const {
+    planes[2 * CONST0_NODE] = ~0ull;
+    planes[2 * CONST0_NODE + 1] = ~0ull;
+    planes[2 * CONST1_NODE] = ~0ull;
+    planes[2 * CONST1_NODE + 1] = 0;
+
+    if (pool && pool->GetThreadCount() > 1 && widestLevel >= PARALLEL_MIN_LEVEL_NODES) {
+        ParallelEvaluation run = { this, planes, unstable, true, pool };
+        pool->Run(EvaluateShareTask, &run);
+        return;
+    }
+
+    int spans = (int)spanKernels.size() - 1;
+    for (int l = 0; l < spans; l++) {
+        for (int k = spanKernels[l]; k < spanKernels[l + 1]; k++) {
+            RunKernel4(kernels[k], planes);
+        }
+        if (l == (int)loops.size()) break;
+
+        bool settled = SettleLoop4(loops[l], planes);
+        if (unstable) unstable[l] = !settled;
+    }
+}
+
+// Iterate one loop until neither plane changes; a latch that was never set
+// or reset stays X
+bool LogicGraph::SettleLoop4(const Loop& loop, uint64_t* planes) const {
+    for (int pass = 0; pass < MAX_LOOP_ITERATIONS; pass++) {
+        bool changed = false;
+        for (int i = loop.begin; i < loop.end; i++) {
+            int n = order[i];
+            uint64_t high, low;
+            EvaluateNode4(n, planes, high, low);
+            if (high != planes[2 * n] || low != planes[2 * n + 1]) {
+                planes[2 * n] = high;
+                planes[2 * n + 1] = low;
+                changed = true;
+            }
+        }
+        if (!changed) return true;
+    }
+    return false;
+}
+
+// Both planes of a single node from its fanin planes
+void LogicGraph::EvaluateNode4(int n, const uint64_t* planes, uint64_t& high, uint64_t& low) const {
+    const int* in = fanin.data() + faninStart[n];
+    int count = faninStart[n + 1] - faninStart[n];
+    NodeOp op = ops[n];
+
+    switch (op) {
+    case NodeOp::BUF:
+    case NodeOp::NOT:
+        high = planes[2 * in[0]];
+        low = planes[2 * in[0] + 1];
+        break;
+    case NodeOp::SLICE:
+        high = (planes[2 * in[0]] & BusMask(widths[in[0]])) >> shifts[n];
+        low = (planes[2 * in[0] + 1] & BusMask(widths[in[0]])) >> shifts[n];
+        return;
+    case NodeOp::MERGE:
+        high = MergePins(in, count, planes, 2);
+        low = MergePins(in, count, planes + 1, 2);
+        return;
+    case NodeOp::AND:
+    case NodeOp::NAND:
+        high = ~0ull;
+        low = 0;
+        for (int i = 0; i < count; i++) {
+            high &= planes[2 * in[i]];
+            low |= planes[2 * in[i] + 1];
+        }
+        break;
+    case NodeOp::OR:
+    case NodeOp::NOR:
+        high = 0;
+        low = ~0ull;
+        for (int i = 0; i < count; i++) {
+            high |= planes[2 * in[i]];
+            low &= planes[2 * in[i] + 1];
+        }
+        break;
+    default:
+        high = planes[2 * n];
+        low = planes[2 * n + 1];
+        return;
+    }
+    if (op == NodeOp::NOT || op == NodeOp::NAND || op == NodeOp::NOR) std::swap(high, low);
+}
+
+// Copy one lane of both planes back into the visible gates and wires; pins
+// without a wire show Z
+void LogicGraph::WriteBack4(const uint64_t* planes, int lane, std::vector<std::unique_ptr<Gate>>& gates,
+    const WiringSystem& wiring) const {
+    for (int g = 0; g < (int)gates.size(); g++) {
+        Gate& gate = *gates[g];
+        int node = gateNode[g];
+        if (gate.GetType() == GateType::INPUT) {
+            gate.busValue = gate.GetSwitchValue();
+            gate.outputLevel = gate.busValue ? Logic::ONE : Logic::ZERO;
+        }
+        else if (node < 0) {
+            gate.busValue = 0;
+            gate.outputLevel = Logic::X;
+        }
+        else if (gate.IsBus()) {
+            // A bus is known when every bit is exactly one of 0 and 1
+            uint64_t mask = BusMask(gate.GetWidth());
+            uint64_t high = planes[2 * node] & mask;
+            bool known = ((high ^ planes[2 * node + 1]) & mask) == mask;
+            gate.busValue = high;
+            gate.outputLevel = !known ? Logic::X : high ? Logic::ONE : Logic::ZERO;
+        }
+        else {
+            gate.outputLevel = (Logic)(((planes[2 * node] >> lane) & 1) | (((planes[2 * node + 1] >> lane) & 1) << 1));
+            gate.busValue = gate.outputLevel == Logic::ONE;
+        }
+        gate.output = gate.outputLevel == Logic::ONE;
+    }
+
+    for (int g = 0; g < (int)gates.size(); g++) {
+        Gate& gate = *gates[g];
+        for (int i = 0; i < gate.GetInputCount(); i++) {
+            Wire* wire = wiring.GetFaninWire(g, i);
+            gate.inputLevels[i] = wire ? gates[wire->fromGateIndex]->outputLevel : Logic::Z;
+            gate.inputs[i] = gate.inputLevels[i] == Logic::ONE;
+            if (wire) {
+                wire->state = gate.inputs[i] != 0;
+                wire->level = gate.inputLevels[i];
+                wire->busValue = gates[wire->fromGateIndex]->busValue;
+            }
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,137 @@
+#ifndef LOGIC_GRAPH_H
+#define LOGIC_GRAPH_H
+
+#include "Constants.h"
+#include "Gate.h"
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+// Forward declaration to avoid circular dependency
+class WiringSystem;
+class EvaluationPool;
+
+// ================================
+// LOGIC GRAPH
+// ================================
+// Operation of one evaluation node. OUTPUT gates become BUF nodes and
+// unconnected pins read the CONST0 node. SLICE and MERGE only occur in
+// circuits with buses.
+enum class NodeOp : uint8_t {
+    CONST0, CONST1, INPUT, BUF, NOT, AND, OR, NAND, NOR, SLICE, MERGE
+};
+
+// Flattened, levelized copy of the gate/wire graph used by the evaluation
+// engines. Fanin lists are stored contiguously (CSR), and every node value is
+// a 64-bit word so one pass evaluates 64 independent patterns.
+//
+// A circuit with buses (hasBuses) uses the word differently: bit i of a node
+// is bit i of its bus, so the bitwise kernels evaluate every bit of a bus
+// gate at once and only SLICE / MERGE move bits between positions. Such a
+// graph evaluates one pattern, in lane 0 of the 1-bit nodes.
+class LogicGraph {
+public:
+    enum { CONST0_NODE = 0, CONST1_NODE = 1 };
+
+    // A combinational loop (strongly connected component): order[begin .. end)
+    struct Loop {
+        int begin;
+        int end;
+    };
+
+    // Nodes of one level that share an operation: schedule[begin .. end)
+    struct Kernel {
+        NodeOp op;
+        int begin;
+        int end;
+    };
+
+    // All kernels of one level: kernels[kernelBegin .. kernelEnd), which
+    // cover schedule[nodeBegin .. nodeEnd)
+    struct Level {
+        int kernelBegin;
+        int kernelEnd;
+        int nodeBegin;
+        int nodeEnd;
+    };
+
+    std::vector<NodeOp> ops;
+    std::vector<int> faninStart;    // Fanin of node n: fanin[faninStart[n] .. faninStart[n + 1])
+    std::vector<int> fanin;
+    std::vector<int> order;         // Evaluation order of every node that is not a constant or INPUT
+    std::vector<Loop> loops;        // Cyclic components, in evaluation order
+    std::vector<int> loopOf;        // Node -> index in loops, -1 if not on a loop
+    std::vector<int> schedule;      // Acyclic nodes of order, by level, then operation, then fanin count
+    std::vector<Kernel> kernels;
+    std::vector<int> spanKernels;   // Acyclic span l runs before loop l: kernels[spanKernels[l] .. spanKernels[l + 1])
+    std::vector<Level> levels;      // Levels of span l: levels[spanLevels[l] .. spanLevels[l + 1])
+    std::vector<int> spanLevels;
+    int widestLevel = 0;            // Nodes in the largest level
+    std::vector<int> inputs;        // INPUT nodes, in gate order
+    std::vector<int> outputs;       // Node observed by each OUTPUT gate, in gate order
+    std::vector<int> gateNode;      // Gate index -> node carrying its output (-1 = optimized away)
+    std::vector<uint8_t> widths;    // Bits of each node (1 unless it carries a bus)
+    std::vector<uint8_t> shifts;    // First input bit taken by a SLICE node, 0 otherwise
+    bool hasCycles = false;
+    bool hasBuses = false;          // Some node is wider than a bit, or slices / merges
+
+    // Compile the visible circuit; node n + 2 is gate n
+    void Build(const std::vector<std::unique_ptr<Gate>>& gates, const WiringSystem& wiring);
+
+    // Append a node (constants must already exist)
+    int AddNode(NodeOp op, const int* faninNodes, int count);
+    int NodeCount() const;
+
+    // Recompute the evaluation order: components in topological order, each
+    // loop kept contiguous; then rebuild the kernels
+    void Levelize();
+
+    // Group each acyclic span between loops into per-level, per-operation kernels
+    void BuildKernels();
+
+    // Evaluate every node of a kernel with a loop specialized for its operation;
+    // RunNodes takes schedule[begin .. end) of nodes sharing op
+    void RunKernel(const Kernel& kernel, uint64_t* values) const;
+    void RunNodes(NodeOp op, int begin, int end, uint64_t* values) const;
+
+    // Evaluate all nodes; values[] holds one word per node with INPUT words preset.
+    // Acyclic nodes are evaluated once, kernel by kernel; loops are iterated to a fixpoint (at most
+    // MAX_LOOP_ITERATIONS passes, starting from the values already in values[]);
+    // unstable[l] is set when loop l did not settle. With a pool, levels of at
+    // least PARALLEL_MIN_LEVEL_NODES nodes are split across its threads
+    void Evaluate(uint64_t* values, unsigned char* unstable = nullptr, EvaluationPool* pool = nullptr) const;
+
+    // One worker's share of a parallel evaluation (words are four-valued
+    // plane pairs if fourValued): its static chunk of every wide level, and,
+    // on worker 0, the narrow levels and loops, with barriers in between
+    void EvaluateShare(uint64_t* words, unsigned char* unstable, bool fourValued, EvaluationPool& pool, int worker) const;
+
+    // Iterate one loop until no value changes; false if it is still oscillating
+    bool SettleLoop(const Loop& loop, uint64_t* values) const;
+
+    // Value of a single node from its fanin words; the second form forces one pin
+    uint64_t EvaluateNode(int n, const uint64_t* values) const;
+    uint64_t EvaluateNodeWithPin(int n, const uint64_t* values, int pin, uint64_t pinValue) const;
+
+    // Pins of a MERGE node packed side by side (stride 2 reads one plane of
+    // four-valued words)
+    uint64_t MergePins(const int* in, int count, const uint64_t* values, int stride) const;
+
+    // Copy one pattern lane back into the visible gates and wires (all bits of a bus)
+    void WriteBack(const uint64_t* values, int lane, std::vector<std::unique_ptr<Gate>>& gates,
+        const WiringSystem& wiring) const;
+
+    // Four-valued counterparts over two bit-planes per node (see Logic):
+    // planes[2n] = node n may be 1, planes[2n + 1] = it may be 0. The graph
+    // must not be optimized: its CONST0 node only feeds unconnected pins, which
+    // read X, and WriteBack4 shows those pins as Z
+    void RunKernel4(const Kernel& kernel, uint64_t* planes) const;
+    void RunNodes4(NodeOp op, int begin, int end, uint64_t* planes) const;
+    void Evaluate4(uint64_t* planes, unsigned char* unstable = nullptr, EvaluationPool* pool = nullptr) const;
+    bool SettleLoop4(const Loop& loop, uint64_t* planes) const;
+    void EvaluateNode4(int n, const uint64_t* planes, uint64_t& high, uint64_t& low) const;
+    void WriteBack4(const uint64_t* planes, int lane, std::vector<std::unique_ptr<Gate>>& gates,
+        const WiringSystem& wiring) const;
+};
+
+#endif // LOGIC_GRAPH_H
\ No newline at end of file
@@ -0,0 +1,185 @@
+#include "LogicOptimizer.h"
+#include <unordered_map>
+#include <algorithm>
+
+// ================================
+// OPTIMIZER HELPERS
+// ================================
+namespace {
+
+// Node under construction (fanins are ids in the new graph)
+struct WorkNode {
+    NodeOp op;
+    std::vector<int> fanin;
+};
+
+struct KeyHash {
+    size_t operator()(const std::vector<int>& key) const {
+        size_t h = 1469598103934665603ull;
+        for (int v : key) h = (h ^ (size_t)(unsigned)v) * 1099511628211ull;
+        return h;
+    }
+};
+
+class Builder {
+public:
+    std::vector<WorkNode> nodes;
+    LogicOptimizer::Stats& stats;
+
+    explicit Builder(LogicOptimizer::Stats& s) : stats(s) {
+        nodes.push_back({ NodeOp::CONST0, {} });
+        nodes.push_back({ NodeOp::CONST1, {} });
+    }
+
+    int Append(NodeOp op, std::vector<int> fanin) {
+        nodes.push_back({ op, std::move(fanin) });
+        return (int)nodes.size() - 1;
+    }
+
+    // Inverter with constant folding and double-inversion collapsing
+    int Not(int a) {
+        if (a == LogicGraph::CONST0_NODE) { stats.constantsFolded++; return LogicGraph::CONST1_NODE; }
+        if (a == LogicGraph::CONST1_NODE) { stats.constantsFolded++; return LogicGraph::CONST0_NODE; }
+        if (nodes[a].op == NodeOp::NOT && !nodes[a].fanin.empty()) {
+            stats.inversionsCollapsed++;
+            return nodes[a].fanin[0];
+        }
+        return Hashed(NodeOp::NOT, { a });
+    }
+
+    // AND/OR/NAND/NOR with constant folding, duplicate removal and hashing
+    int Reduce(NodeOp op, std::vector<int> fanin) {
+        bool andLike = (op == NodeOp::AND || op == NodeOp::NAND);
+        bool inverting = (op == NodeOp::NAND || op == NodeOp::NOR);
+        int identity = andLike ? LogicGraph::CONST1_NODE : LogicGraph::CONST0_NODE;
+        int dominant = andLike ? LogicGraph::CONST0_NODE : LogicGraph::CONST1_NODE;
+
+        size_t before = fanin.size();
+        if (std::find(fanin.begin(), fanin.end(), dominant) != fanin.end()) {
+            stats.constantsFolded++;
+            return inverting ? Not(dominant) : dominant;
+        }
+        fanin.erase(std::remove(fanin.begin(), fanin.end(), identity), fanin.end());
+        if (fanin.size() != before) stats.constantsFolded++;
+
+        std::sort(fanin.begin(), fanin.end());
+        fanin.erase(std::unique(fanin.begin(), fanin.end()), fanin.end());
+
+        if (fanin.empty()) return inverting ? Not(identity) : identity;
+        if (fanin.size() == 1) return inverting ? Not(fanin[0]) : fanin[0];
+        return Hashed(op, std::move(fanin));
+    }
+
+    int Hashed(NodeOp op, std::vector<int> fanin) {
+        std::vector<int> key(fanin);
+        key.push_back((int)op);
+
+        auto it = table.find(key);
+        if (it != table.end()) {
+            stats.structuralMerges++;
+            return it->second;
+        }
+        int id = Append(op, std::move(fanin));
+        table.emplace(std::move(key), id);
+        return id;
+    }
+
+private:
+    std::unordered_map<std::vector<int>, int, KeyHash> table;
+};
+
+} // namespace
+
+// ================================
+// LOGIC OPTIMIZER IMPLEMENTATION
+// ================================
+LogicGraph LogicOptimizer::Optimize(const LogicGraph& graph, Stats* statsOut) {
+    Stats stats;
+    stats.nodesBefore = graph.NodeCount();
+    Builder builder(stats);
+
+    // repr[n]: node in the work graph that carries the value of old node n
+    const int UNKNOWN = -1;
+    std::vector<int> repr(graph.NodeCount(), UNKNOWN);
+    repr[LogicGraph::CONST0_NODE] = LogicGraph::CONST0_NODE;
+    repr[LogicGraph::CONST1_NODE] = LogicGraph::CONST1_NODE;
+    for (int n : graph.inputs) {
+        repr[n] = builder.Append(NodeOp::INPUT, {});
+    }
+
+    // Nodes that read a value not produced yet (they sit on a loop) are copied as-is
+    std::vector<int> opaque;
+    std::vector<int> fanin;
+    for (int n : graph.order) {
+        fanin.clear();
+        bool resolved = true;
+        for (int k = graph.faninStart[n]; k < graph.faninStart[n + 1]; k++) {
+            int f = repr[graph.fanin[k]];
+            if (f == UNKNOWN) resolved = false;
+            fanin.push_back(f);
+        }
+
+        if (!resolved) {
+            repr[n] = builder.Append(graph.ops[n], {});
+            opaque.push_back(n);
+            continue;
+        }
+
+        switch (graph.ops[n]) {
+        case NodeOp::BUF: repr[n] = fanin[0]; break;
+        case NodeOp::NOT: repr[n] = builder.Not(fanin[0]); break;
+        default: repr[n] = builder.Reduce(graph.ops[n], fanin); break;
+        }
+    }
+    for (int n : opaque) {
+        std::vector<int>& target = builder.nodes[repr[n]].fanin;
+        for (int k = graph.faninStart[n]; k < graph.faninStart[n + 1]; k++) {
+            target.push_back(repr[graph.fanin[k]]);
+        }
+    }
+
+    // Keep only what reaches an OUTPUT (plus constants and inputs)
+    std::vector<WorkNode>& work = builder.nodes;
+    std::vector<unsigned char> live(work.size(), 0);
+    std::vector<int> stack;
+    live[LogicGraph::CONST0_NODE] = live[LogicGraph::CONST1_NODE] = 1;
+    for (int n : graph.inputs) live[repr[n]] = 1;
+    for (int n : graph.outputs) stack.push_back(repr[n]);
+    while (!stack.empty()) {
+        int n = stack.back();
+        stack.pop_back();
+        if (live[n]) continue;
+        live[n] = 1;
+        for (int f : work[n].fanin) {
+            if (!live[f]) stack.push_back(f);
+        }
+    }
+
+    // Compact into a fresh CSR graph
+    LogicGraph result;
+    std::vector<int> remap(work.size(), -1);
+    for (int n = 0; n < (int)work.size(); n++) {
+        if (live[n]) remap[n] = result.AddNode(work[n].op, nullptr, 0);
+        else if (n > LogicGraph::CONST1_NODE && work[n].op != NodeOp::INPUT) stats.deadRemoved++;
+    }
+    result.fanin.clear();
+    result.faninStart.assign(1, 0);
+    for (int n = 0; n < (int)work.size(); n++) {
+        if (!live[n]) continue;
+        for (int f : work[n].fanin) result.fanin.push_back(remap[f]);
+        result.faninStart.push_back((int)result.fanin.size());
+    }
+
+    for (int n : graph.inputs) result.inputs.push_back(remap[repr[n]]);
+    for (int n : graph.outputs) result.outputs.push_back(remap[repr[n]]);
+    result.gateNode.resize(graph.gateNode.size(), -1);
+    for (size_t g = 0; g < graph.gateNode.size(); g++) {
+        int n = graph.gateNode[g];
+        if (n >= 0 && repr[n] != UNKNOWN) result.gateNode[g] = remap[repr[n]];
+    }
+    result.Levelize();
+
+    stats.nodesAfter = result.NodeCount();
+    if (statsOut) *statsOut = stats;
+    return result;
+}
\ No newline at end of file
@@ -0,0 +1,31 @@
+#ifndef LOGIC_OPTIMIZER_H
+#define LOGIC_OPTIMIZER_H
+
+#include "LogicGraph.h"
+
+// ================================
+// LOGIC OPTIMIZER CLASS DECLARATION
+// ================================
+// Optional pass that shrinks a LogicGraph before heavy simulation runs:
+//  - constant propagation (unconnected pins read 0, so e.g. a NAND with a
+//    dangling pin folds to 1)
+//  - buffer and double-inversion collapsing
+//  - structural hashing of identical gates (commutative fanins are sorted)
+//  - removal of logic that reaches no OUTPUT
+// The result keeps gateNode, so values can still be shown on the visible
+// gates; gates whose logic was removed map to -1.
+class LogicOptimizer {
+public:
+    struct Stats {
+        int nodesBefore = 0;
+        int nodesAfter = 0;
+        int constantsFolded = 0;
+        int inversionsCollapsed = 0;
+        int structuralMerges = 0;
+        int deadRemoved = 0;
+    };
+
+    static LogicGraph Optimize(const LogicGraph& graph, Stats* stats = nullptr);
+};
+
+#endif // LOGIC_OPTIMIZER_H
\ No newline at end of file
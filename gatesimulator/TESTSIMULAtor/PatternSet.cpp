@@ -0,0 +1,138 @@
+#include "PatternSet.h"
+#include "StimulusRunner.h"
+#include <fstream>
+
+// ================================
+// PATTERN SET CLASS IMPLEMENTATION
+// ================================
+
+// Constructor
+PatternSet::PatternSet(int inputs) : inputCount(inputs) {
+}
+
+int PatternSet::GetInputCount() const {
+    return inputCount;
+}
+
+int PatternSet::GetPatternCount() const {
+    return patternCount;
+}
+
+int PatternSet::GetBlockCount() const {
+    return (patternCount + 63) / 64;
+}
+
+// Lanes of a block that hold real patterns
+uint64_t PatternSet::GetLaneMask(int block) const {
+    int lanes = patternCount - block * 64;
+    return lanes >= 64 ? ~0ull : (1ull << lanes) - 1;
+}
+
+// Packed value of one input across the 64 patterns of a block
+uint64_t PatternSet::Word(int block, int input) const {
+    return words[(size_t)block * inputCount + input];
+}
+
+// Append one vector
+void PatternSet::AddPattern(const std::vector<unsigned char>& values) {
+    int block = patternCount / 64;
+    int lane = patternCount % 64;
+    if (lane == 0) {
+        words.resize(words.size() + inputCount, 0);
+    }
+
+    uint64_t* row = &words[(size_t)block * inputCount];
+    for (int i = 0; i < inputCount && i < (int)values.size(); i++) {
+        if (values[i]) row[i] |= 1ull << lane;
+    }
+    patternCount++;
+}
+
+// Append pseudo-random vectors (xorshift64*)
+void PatternSet::AddRandom(int count, uint64_t seed) {
+    uint64_t state = seed ? seed : 0x9E3779B97F4A7C15ull;
+    std::vector<unsigned char> values(inputCount);
+
+    for (int p = 0; p < count; p++) {
+        for (int i = 0; i < inputCount; i++) {
+            state ^= state >> 12;
+            state ^= state << 25;
+            state ^= state >> 27;
+            values[i] = ((state * 0x2545F4914F6CDD1Dull) >> 63) & 1;
+        }
+        AddPattern(values);
+    }
+}
+
+// Parse one text line into values
+bool PatternSet::ParseLine(const std::string& line, std::vector<unsigned char>& values) {
+    values.clear();
+    for (char c : line) {
+        if (c == '#') break;
+        if (c == '0' || c == '1') values.push_back(c == '1');
+    }
+    return !values.empty();
+}
+
+// Load a whole text file
+bool PatternSet::LoadText(const std::string& path, std::string& error) {
+    std::ifstream file(path);
+    if (!file) {
+        error = "cannot open " + path;
+        return false;
+    }
+
+    std::string line;
+    std::vector<unsigned char> values;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        if (!ParseLine(line, values)) continue;
+        if ((int)values.size() != inputCount) {
+            error = path + ":" + std::to_string(lineNumber) + ": expected " +
+                std::to_string(inputCount) + " values, got " + std::to_string(values.size());
+            return false;
+        }
+        AddPattern(values);
+    }
+    return true;
+}
+
+// Load a whole raw binary file
+bool PatternSet::LoadBinary(const std::string& path, std::string& error) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        error = "cannot open " + path;
+        return false;
+    }
+
+    size_t vectorBytes = (inputCount + 7) / 8;
+    if (vectorBytes == 0) {
+        error = path + ": nothing to read for a circuit without inputs";
+        return false;
+    }
+
+    std::vector<char> bytes(vectorBytes * 4096);
+    std::vector<unsigned char> values(inputCount);
+    for (;;) {
+        file.read(bytes.data(), bytes.size());
+        size_t got = (size_t)file.gcount();
+        if (got % vectorBytes != 0) {
+            error = path + ": truncated vector at the end of the file";
+            return false;
+        }
+        for (size_t at = 0; at < got; at += vectorBytes) {
+            for (int i = 0; i < inputCount; i++) {
+                values[i] = (bytes[at + (i >> 3)] >> (i & 7)) & 1;
+            }
+            AddPattern(values);
+        }
+        if (got < bytes.size()) break;
+    }
+    return true;
+}
+
+// Load a text or binary file, chosen by its extension
+bool PatternSet::Load(const std::string& path, std::string& error) {
+    return StimulusRunner::IsBinaryPath(path) ? LoadBinary(path, error) : LoadText(path, error);
+}
\ No newline at end of file
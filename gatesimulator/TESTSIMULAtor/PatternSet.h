@@ -0,0 +1,54 @@
+#ifndef PATTERN_SET_H
+#define PATTERN_SET_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+// ================================
+// PATTERN SET CLASS DECLARATION
+// ================================
+// Test vectors packed 64 to a word: bit p of Word(block, input) is the value
+// of that INPUT in pattern block * 64 + p. Text files hold one vector per
+// line as 0/1 characters in INPUT gate order (# starts a comment, any other
+// character is ignored). Files ending in ".bin" hold raw vectors of
+// (inputCount + 7) / 8 bytes each, LSB first.
+class PatternSet {
+private:
+    int inputCount = 0;
+    int patternCount = 0;
+    std::vector<uint64_t> words;    // words[block * inputCount + input]
+
+public:
+    explicit PatternSet(int inputs = 0);
+
+    int GetInputCount() const;
+    int GetPatternCount() const;
+    int GetBlockCount() const;
+
+    // Lanes of a block that hold real patterns
+    uint64_t GetLaneMask(int block) const;
+
+    // Packed value of one input across the 64 patterns of a block
+    uint64_t Word(int block, int input) const;
+
+    // Append one vector (values[i] != 0 means 1)
+    void AddPattern(const std::vector<unsigned char>& values);
+
+    // Append pseudo-random vectors
+    void AddRandom(int count, uint64_t seed);
+
+    // Parse one text line into values; false if the line holds no vector
+    static bool ParseLine(const std::string& line, std::vector<unsigned char>& values);
+
+    // Load a whole text file
+    bool LoadText(const std::string& path, std::string& error);
+
+    // Load a whole raw binary file
+    bool LoadBinary(const std::string& path, std::string& error);
+
+    // Load a text or binary file, chosen by its extension
+    bool Load(const std::string& path, std::string& error);
+};
+
+#endif // PATTERN_SET_H
\ No newline at end of file
@@ -0,0 +1,68 @@
+#include "PickService.h"
+#include "raymath.h"
+
+// ================================
+// PICK SERVICE CLASS IMPLEMENTATION
+// ================================
+
+// Hit-test a point, scanning the scene only when the point or the scene changed
+PickResult PickService::Pick(Vector2 point, unsigned int sceneVersion, const std::vector<std::unique_ptr<Gate>>& gates,
+    const SegmentHash& segments) {
+    std::lock_guard<std::mutex> guard(lock);
+    queries++;
+
+    if (!valid || cachedVersion != sceneVersion || cachedPoint.x != point.x || cachedPoint.y != point.y) {
+        cached = Scan(point, gates, segments);
+        cachedPoint = point;
+        cachedVersion = sceneVersion;
+        valid = true;
+    }
+    return cached;
+}
+
+// Forget the cached result
+void PickService::Invalidate() {
+    std::lock_guard<std::mutex> guard(lock);
+    valid = false;
+}
+
+unsigned long long PickService::GetScanCount() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return scans;
+}
+
+unsigned long long PickService::GetQueryCount() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return queries;
+}
+
+// Scan every gate and pin, and the wire segments near the point
+PickResult PickService::Scan(Vector2 point, const std::vector<std::unique_ptr<Gate>>& gates,
+    const SegmentHash& segments) {
+    PickResult result;
+    scans++;
+
+    for (int i = 0; i < (int)gates.size(); i++) {
+        if (result.gateIndex == -1 && gates[i]->ContainsPoint(point)) {
+            result.gateIndex = i;
+        }
+
+        if (!result.hasPin) {
+            gates[i]->GetConnectionPoints(i, pointScratch);
+            for (const auto& pin : pointScratch) {
+                if (Vector2Distance(point, pin.position) <= CONNECTION_SNAP_DISTANCE) {
+                    result.hasPin = true;
+                    result.pin = pin;
+                    break;
+                }
+            }
+        }
+    }
+
+    const Wire* wire = segments.FindNearest(point, WIRE_PICK_DISTANCE);
+    if (wire) {
+        result.wireGate = wire->toGateIndex;
+        result.wireInput = wire->toInputIndex;
+    }
+    return result;
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+#ifndef PICK_SERVICE_H
+#define PICK_SERVICE_H
+
+#include "raylib.h"
+#include "Constants.h"
+#include "Gate.h"
+#include "Wire.h"
+#include "SegmentHash.h"
+#include <vector>
+#include <memory>
+#include <mutex>
+
+// ================================
+// PICK RESULT
+// ================================
+// What lies under a point, returned by value. The first gate / pin in scene
+// order wins; for wires the closest one within WIRE_PICK_DISTANCE does.
+struct PickResult {
+    int gateIndex = -1;             // Gate body containing the point
+    bool hasPin = false;            // A connection point within snap distance
+    ConnectionPoint pin = ConnectionPoint({ 0, 0 }, false, -1, 0);
+    int wireGate = -1;              // Wire nearest the point, identified by the input it drives
+    int wireInput = -1;
+};
+
+// ================================
+// PICK SERVICE CLASS DECLARATION
+// ================================
+// Hover / click hit-testing shared by every consumer. The scene is scanned at
+// most once per (point, scene version); repeated queries in the same frame
+// return the cached result. Queries are serialized by a mutex so any thread
+// may ask, as long as the scene itself is not being edited concurrently.
+class PickService {
+public:
+    // Hit-test a point; sceneVersion must change whenever gates or wires move
+    PickResult Pick(Vector2 point, unsigned int sceneVersion, const std::vector<std::unique_ptr<Gate>>& gates,
+        const SegmentHash& segments);
+
+    // Forget the cached result
+    void Invalidate();
+
+    // Cache statistics
+    unsigned long long GetScanCount() const;
+    unsigned long long GetQueryCount() const;
+
+private:
+    mutable std::mutex lock;
+    bool valid = false;
+    Vector2 cachedPoint = { 0, 0 };
+    unsigned int cachedVersion = 0;
+    PickResult cached;
+    std::vector<ConnectionPoint> pointScratch;
+    unsigned long long scans = 0;
+    unsigned long long queries = 0;
+
+    // Scan every gate and pin, and the wire segments near the point
+    PickResult Scan(Vector2 point, const std::vector<std::unique_ptr<Gate>>& gates,
+        const SegmentHash& segments);
+};
+
+#endif // PICK_SERVICE_H
\ No newline at end of file
@@ -0,0 +1,120 @@
+#include "SegmentHash.h"
+#include <cmath>
+
+// ================================
+// SEGMENT HASH CLASS IMPLEMENTATION
+// ================================
+
+// Constructor
+SegmentHash::SegmentHash(float cellSize) : cellSize(cellSize) {
+}
+
+// File every segment of a wire's current route
+void SegmentHash::Insert(Wire* wire) {
+    const std::vector<Vector2>& points = wire->waypoints;
+    if (points.size() < 2) return;
+
+    std::vector<Location>& placed = locations[wire];
+    for (int s = 0; s + 1 < (int)points.size(); s++) {
+        int x0, y0, x1, y1;
+        CellRange(points[s], points[s + 1], x0, y0, x1, y1);
+        for (int y = y0; y <= y1; y++) {
+            for (int x = x0; x <= x1; x++) {
+                std::vector<Entry>& entries = cells[Key(x, y)];
+                placed.push_back({ &entries, entries.size() });
+                entries.push_back({ wire, s, (int)placed.size() - 1 });
+                entryCount++;
+            }
+        }
+    }
+}
+
+// Unfile a wire: each entry is overwritten by the last one of its cell,
+// whose handle then follows it
+void SegmentHash::Remove(const Wire* wire) {
+    auto found = locations.find(wire);
+    if (found == locations.end()) return;
+
+    for (const Location& location : found->second) {
+        std::vector<Entry>& entries = *location.cell;
+        const Entry moved = entries.back();
+        entries.pop_back();
+        entryCount--;
+        if (location.index < entries.size()) {
+            entries[location.index] = moved;
+            locations[moved.wire][moved.handle].index = location.index;
+        }
+    }
+    // The emptied list keeps its capacity, so refiling a moved wire does not allocate
+    found->second.clear();
+}
+
+// Drop every entry
+void SegmentHash::Clear() {
+    cells.clear();
+    locations.clear();
+    entryCount = 0;
+}
+
+// Closest wire within threshold of the point, nullptr if none
+const Wire* SegmentHash::FindNearest(Vector2 point, float threshold) const {
+    int x0, y0, x1, y1;
+    CellRange({ point.x - threshold, point.y - threshold }, { point.x + threshold, point.y + threshold }, x0, y0, x1, y1);
+
+    const Wire* nearest = nullptr;
+    float best = threshold;
+    for (int y = y0; y <= y1; y++) {
+        for (int x = x0; x <= x1; x++) {
+            auto cell = cells.find(Key(x, y));
+            if (cell == cells.end()) continue;
+
+            for (const Entry& entry : cell->second) {
+                const std::vector<Vector2>& points = entry.wire->waypoints;
+                float distance = Wire::DistanceToLineSegment(point, points[entry.segment], points[entry.segment + 1]);
+                if (distance <= best) {
+                    best = distance;
+                    nearest = entry.wire;
+                }
+            }
+        }
+    }
+    return nearest;
+}
+
+// Append every wire with a segment touching the area
+void SegmentHash::Collect(Rectangle area, std::vector<Wire*>& found) const {
+    int x0, y0, x1, y1;
+    CellRange({ area.x, area.y }, { area.x + area.width, area.y + area.height }, x0, y0, x1, y1);
+
+    for (int y = y0; y <= y1; y++) {
+        for (int x = x0; x <= x1; x++) {
+            auto cell = cells.find(Key(x, y));
+            if (cell == cells.end()) continue;
+
+            for (const Entry& entry : cell->second) {
+                Vector2 a = entry.wire->waypoints[entry.segment];
+                Vector2 b = entry.wire->waypoints[entry.segment + 1];
+                if (std::fmax(a.x, b.x) >= area.x && std::fmin(a.x, b.x) <= area.x + area.width &&
+                    std::fmax(a.y, b.y) >= area.y && std::fmin(a.y, b.y) <= area.y + area.height) {
+                    found.push_back(entry.wire);
+                }
+            }
+        }
+    }
+}
+
+size_t SegmentHash::GetEntryCount() const {
+    return entryCount;
+}
+
+// Range of cells covered by the bounding box of two points
+void SegmentHash::CellRange(Vector2 a, Vector2 b, int& x0, int& y0, int& x1, int& y1) const {
+    x0 = (int)std::floor(std::fmin(a.x, b.x) / cellSize);
+    y0 = (int)std::floor(std::fmin(a.y, b.y) / cellSize);
+    x1 = (int)std::floor(std::fmax(a.x, b.x) / cellSize);
+    y1 = (int)std::floor(std::fmax(a.y, b.y) / cellSize);
+}
+
+uint64_t SegmentHash::Key(int x, int y) {
+    return ((uint64_t)(uint32_t)x << 32) | (uint32_t)y;
+}
\ No newline at end of file
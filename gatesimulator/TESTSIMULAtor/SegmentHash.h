@@ -0,0 +1,66 @@
+#ifndef SEGMENT_HASH_H
+#define SEGMENT_HASH_H
+
+#include "raylib.h"
+#include "Constants.h"
+#include "Wire.h"
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+// ================================
+// SEGMENT HASH CLASS DECLARATION
+// ================================
+// Spatial hash of routed wire segments on a uniform grid. Every segment is
+// filed under each cell its bounding box touches, so a hit test only measures
+// the segments in the few cells around the point instead of every wire.
+// Each wire keeps handles to its entries, so removal swaps and pops them in
+// O(entries) however crowded the cells are.
+class SegmentHash {
+public:
+    explicit SegmentHash(float cellSize = WIRE_HASH_CELL_SIZE);
+
+    // File / unfile every segment of a wire's current route (a wire is filed at
+    // most once; reroute it by removing and inserting again)
+    void Insert(Wire* wire);
+    void Remove(const Wire* wire);
+
+    // Drop every entry
+    void Clear();
+
+    // Closest wire within threshold of the point, nullptr if none
+    const Wire* FindNearest(Vector2 point, float threshold) const;
+
+    // Append every wire with a segment touching the area (a wire may be listed more than once)
+    void Collect(Rectangle area, std::vector<Wire*>& found) const;
+
+    size_t GetEntryCount() const;
+
+private:
+    struct Entry {
+        Wire* wire;
+        int segment;            // Index of the segment's first waypoint
+        int handle;             // Index into the wire's list of locations
+    };
+
+    // Where one entry of a wire currently sits
+    struct Location {
+        std::vector<Entry>* cell;
+        size_t index;
+    };
+
+    float cellSize;
+    size_t entryCount = 0;
+
+    // Cells and location lists are never erased (only emptied): Location::cell
+    // stays valid, and rerouting a wire every frame does not allocate
+    std::unordered_map<uint64_t, std::vector<Entry>> cells;
+    std::unordered_map<const Wire*, std::vector<Location>> locations;
+
+    // Range of cells covered by a box
+    void CellRange(Vector2 a, Vector2 b, int& x0, int& y0, int& x1, int& y1) const;
+
+    static uint64_t Key(int x, int y);
+};
+
+#endif // SEGMENT_HASH_H
\ No newline at end of file
@@ -0,0 +1,148 @@
+#include "Selection.h"
+#include "WiringSystem.h"
+#include "EditHistory.h"
+#include <cmath>
+
+// ================================
+// SELECTION CLASS IMPLEMENTATION
+// ================================
+
+// Rubber band
+void Selection::BeginBand(Vector2 point) {
+    Clear();
+    banding = true;
+    bandStart = bandEnd = point;
+}
+
+void Selection::UpdateBand(Vector2 point) {
+    bandEnd = point;
+}
+
+// Select every gate the band touches
+void Selection::EndBand(const std::vector<std::unique_ptr<Gate>>& gates, const WiringSystem& wiring) {
+    if (!banding) return;
+    banding = false;
+
+    Rectangle band = GetBand();
+    std::vector<int> inside;
+    for (int g = 0; g < (int)gates.size(); g++) {
+        if (CheckCollisionRecs(band, gates[g]->GetBounds())) inside.push_back(g);
+    }
+    Select(inside, gates.size(), wiring);
+}
+
+bool Selection::IsBanding() const {
+    return banding;
+}
+
+void Selection::SelectAll(const std::vector<std::unique_ptr<Gate>>& gates, const WiringSystem& wiring) {
+    std::vector<int> all(gates.size());
+    for (int g = 0; g < (int)gates.size(); g++) all[g] = g;
+    Select(all, gates.size(), wiring);
+}
+
+void Selection::Clear() {
+    selected.clear();
+    marked.clear();
+    dragging = false;
+}
+
+// Drop the selection if the circuit structure changed behind its back
+void Selection::Validate(const WiringSystem& wiring) {
+    if (!selected.empty() && version != wiring.GetStructureVersion()) Clear();
+}
+
+bool Selection::Contains(int gateIndex) const {
+    return gateIndex >= 0 && gateIndex < (int)marked.size() && marked[gateIndex];
+}
+
+bool Selection::IsEmpty() const {
+    return selected.empty();
+}
+
+const std::vector<int>& Selection::GetGates() const {
+    return selected;
+}
+
+// Block drag
+void Selection::BeginDrag(Vector2 point, const std::vector<std::unique_ptr<Gate>>& gates) {
+    dragging = true;
+    dragLast = point;
+    dragOrigins.clear();
+    for (int g : selected) dragOrigins.push_back(gates[g]->position);
+}
+
+void Selection::UpdateDrag(Vector2 point, std::vector<std::unique_ptr<Gate>>& gates, WiringSystem& wiring) {
+    if (!dragging || (point.x == dragLast.x && point.y == dragLast.y)) return;
+    wiring.MoveGates(selected, { point.x - dragLast.x, point.y - dragLast.y }, gates);
+    dragLast = point;
+}
+
+// Record where every gate went (inside the undo step the caller opened)
+void Selection::EndDrag(const std::vector<std::unique_ptr<Gate>>& gates, EditHistory& history) {
+    if (!dragging) return;
+    dragging = false;
+
+    for (size_t k = 0; k < selected.size(); k++) {
+        Vector2 from = dragOrigins[k];
+        Vector2 to = gates[selected[k]]->position;
+        if (from.x != to.x || from.y != to.y) {
+            history.Record(EditDelta::Move(selected[k], from, to));
+        }
+    }
+}
+
+bool Selection::IsDragging() const {
+    return dragging;
+}
+
+// Clipboard
+void Selection::Copy(const std::vector<std::unique_ptr<Gate>>& gates, const WiringSystem& wiring) {
+    if (selected.empty()) return;
+    wiring.CopyBlock(selected, gates, clipboard);
+}
+
+bool Selection::Paste(Vector2 point, std::vector<std::unique_ptr<Gate>>& gates, WiringSystem& wiring) {
+    if (clipboard.IsEmpty()) return false;
+
+    int first = (int)gates.size();
+    if (!wiring.InsertBlock(clipboard, point, gates)) return false;
+
+    std::vector<int> pasted;
+    for (int g = first; g < (int)gates.size(); g++) pasted.push_back(g);
+    Select(pasted, gates.size(), wiring);
+    return true;
+}
+
+bool Selection::HasClipboard() const {
+    return !clipboard.IsEmpty();
+}
+
+// Remove every selected gate as one undo step
+void Selection::Delete(std::vector<std::unique_ptr<Gate>>& gates, WiringSystem& wiring) {
+    if (selected.empty()) return;
+    wiring.RemoveGates(selected, gates);
+    Clear();
+}
+
+// Draw the rubber band
+void Selection::Draw() const {
+    if (!banding) return;
+    Rectangle band = GetBand();
+    DrawRectangleRec(band, Fade(SKYBLUE, 0.25f));
+    DrawRectangleLinesEx(band, 1, BLUE);
+}
+
+// Replace the selection
+void Selection::Select(const std::vector<int>& gateIndices, size_t gateCount, const WiringSystem& wiring) {
+    Clear();
+    selected = gateIndices;
+    marked.assign(gateCount, 0);
+    for (int g : selected) marked[g] = 1;
+    version = wiring.GetStructureVersion();
+}
+
+Rectangle Selection::GetBand() const {
+    return { std::fmin(bandStart.x, bandEnd.x), std::fmin(bandStart.y, bandEnd.y),
+        std::fabs(bandEnd.x - bandStart.x), std::fabs(bandEnd.y - bandStart.y) };
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+#ifndef SELECTION_H
+#define SELECTION_H
+
+#include "raylib.h"
+#include "Constants.h"
+#include "Gate.h"
+#include "CircuitBlock.h"
+#include <vector>
+#include <memory>
+
+// Forward declarations to avoid circular dependency
+class WiringSystem;
+class EditHistory;
+
+// ================================
+// SELECTION CLASS DECLARATION
+// ================================
+// Gates picked with a rubber band (or all of them) and the block operations
+// on them: drag as one, copy to a clipboard, paste, delete. Every operation
+// goes through the batched WiringSystem block calls. Gate indices are only
+// valid for the structure they were picked in, so any other structural edit
+// (undo, a deleted gate, a loaded file) drops the selection.
+class Selection {
+public:
+    // Rubber band: drag a rectangle, every gate it touches is selected on release
+    void BeginBand(Vector2 point);
+    void UpdateBand(Vector2 point);
+    void EndBand(const std::vector<std::unique_ptr<Gate>>& gates, const WiringSystem& wiring);
+    bool IsBanding() const;
+
+    void SelectAll(const std::vector<std::unique_ptr<Gate>>& gates, const WiringSystem& wiring);
+    void Clear();
+
+    // Drop the selection if the circuit structure changed behind its back
+    void Validate(const WiringSystem& wiring);
+
+    bool Contains(int gateIndex) const;
+    bool IsEmpty() const;
+    const std::vector<int>& GetGates() const;
+
+    // Block drag; the moves are recorded (one delta per gate) when it ends
+    void BeginDrag(Vector2 point, const std::vector<std::unique_ptr<Gate>>& gates);
+    void UpdateDrag(Vector2 point, std::vector<std::unique_ptr<Gate>>& gates, WiringSystem& wiring);
+    void EndDrag(const std::vector<std::unique_ptr<Gate>>& gates, EditHistory& history);
+    bool IsDragging() const;
+
+    // Clipboard: copy the selected gates and their internal wires; paste with
+    // the block's top-left corner at a point and select the pasted gates
+    void Copy(const std::vector<std::unique_ptr<Gate>>& gates, const WiringSystem& wiring);
+    bool Paste(Vector2 point, std::vector<std::unique_ptr<Gate>>& gates, WiringSystem& wiring);
+    bool HasClipboard() const;
+
+    // Remove every selected gate as one undo step
+    void Delete(std::vector<std::unique_ptr<Gate>>& gates, WiringSystem& wiring);
+
+    // Draw the rubber band
+    void Draw() const;
+
+private:
+    std::vector<int> selected;
+    std::vector<unsigned char> marked;  // Per gate index: selected
+    unsigned int version = 0;           // Structure version the indices belong to
+
+    bool banding = false;
+    Vector2 bandStart = { 0, 0 };
+    Vector2 bandEnd = { 0, 0 };
+
+    bool dragging = false;
+    Vector2 dragLast = { 0, 0 };
+    std::vector<Vector2> dragOrigins;   // Position of each selected gate when the drag began
+
+    CircuitBlock clipboard;
+
+    // Replace the selection
+    void Select(const std::vector<int>& gateIndices, size_t gateCount, const WiringSystem& wiring);
+
+    Rectangle GetBand() const;
+};
+
+#endif // SELECTION_H
\ No newline at end of file
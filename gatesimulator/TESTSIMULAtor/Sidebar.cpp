@@ -8,7 +8,8 @@
 Sidebar::Sidebar() {
     gateTypes = {
         GateType::INPUT, GateType::OUTPUT, GateType::AND,
-        GateType::OR, GateType::NOT, GateType::NAND, GateType::NOR
+        GateType::OR, GateType::NOT, GateType::NAND, GateType::NOR,
+        GateType::SPLIT, GateType::MERGE
     };
 }
 
@@ -31,7 +32,7 @@ void Sidebar::Draw(bool hasSelection, GateType selectedType, SimulatorMode mode)
             Rectangle buttonRect = { 40, (float)y, 75, 50 };
 
             // Get gate info for drawing
-            const GateInfo& gateInfo = GATE_DATA.at(gateTypes[i]);
+            const GateInfo& gateInfo = GetGateInfo(gateTypes[i]);
             bool isSelected = hasSelection && selectedType == gateTypes[i];
 
             DrawRectangleRec(buttonRect, gateInfo.color);
@@ -0,0 +1,257 @@
+#include "StimulusRunner.h"
+#include "PatternSet.h"
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+
+// ================================
+// STIMULUS RUNNER CLASS IMPLEMENTATION
+// ================================
+
+// Constructor
+StimulusRunner::StimulusRunner(const LogicGraph& g) : graph(g) {
+    values.assign(graph.NodeCount(), 0);
+    if (!graph.loops.empty()) packed.assign(graph.NodeCount(), 0);
+    batch.assign((size_t)BATCH_BLOCKS * graph.inputs.size(), 0);
+    inBuffer.resize(IO_BUFFER_SIZE);
+    outBuffer.reserve(IO_BUFFER_SIZE + 4096);
+}
+
+// Trace INPUT and OUTPUT values into a VCD writer
+void StimulusRunner::SetTrace(VcdWriter* vcd) {
+    trace = vcd;
+}
+
+// Count node transitions over the run, from zero
+void StimulusRunner::SetActivity(ToggleCounter* counter) {
+    activity = counter;
+    if (activity) activity->Reset(graph.NodeCount());
+}
+
+// Evaluate wide levels on a thread pool
+void StimulusRunner::SetPool(EvaluationPool* workers) {
+    pool = workers;
+}
+
+// True if the path names a raw binary vector file
+bool StimulusRunner::IsBinaryPath(const std::string& path) {
+    return path.size() >= 4 && path.compare(path.size() - 4, 4, ".bin") == 0;
+}
+
+// Simulate every vector of stimulusPath and write one result per vector
+bool StimulusRunner::Run(const std::string& stimulusPath, const std::string& resultsPath, Report& report,
+    std::string& error) {
+    auto start = std::chrono::steady_clock::now();
+    report = Report();
+
+    bool binaryIn = IsBinaryPath(stimulusPath);
+    bool binaryOut = IsBinaryPath(resultsPath);
+    if (binaryIn && graph.inputs.empty()) {
+        error = "circuit has no INPUT gates";
+        return false;
+    }
+    std::ifstream in(stimulusPath, std::ios::binary);
+    if (!in) {
+        error = "cannot open " + stimulusPath;
+        return false;
+    }
+    std::ofstream out(resultsPath, std::ios::binary);
+    if (!out) {
+        error = "cannot write " + resultsPath;
+        return false;
+    }
+
+    int inputCount = (int)graph.inputs.size();
+    size_t vectorBytes = (inputCount + 7) / 8;
+    std::vector<unsigned char> bytes(vectorBytes);
+    std::vector<unsigned char> pins;
+    std::string line;
+    long long lineNumber = 0;
+    int filled = 0;
+    inPos = inEnd = 0;
+    vectorBase = 0;
+    outBuffer.clear();
+
+    for (;;) {
+        // Fetch the next vector
+        if (binaryIn) {
+            size_t got = 0;
+            if (!ReadBytes(in, bytes.data(), vectorBytes, got)) {
+                if (got != 0) {
+                    error = stimulusPath + ": truncated vector at the end of the file";
+                    return false;
+                }
+                break;
+            }
+        }
+        else {
+            if (!ReadLine(in, line)) break;
+            lineNumber++;
+            if (!PatternSet::ParseLine(line, pins)) continue;
+            if ((int)pins.size() != inputCount) {
+                error = stimulusPath + ":" + std::to_string(lineNumber) + ": expected " +
+                    std::to_string(inputCount) + " values, got " + std::to_string(pins.size());
+                return false;
+            }
+        }
+
+        // Transpose it into its lane of the batch
+        uint64_t* row = &batch[(size_t)(filled / 64) * inputCount];
+        uint64_t bit = 1ull << (filled % 64);
+        for (int i = 0; i < inputCount; i++) {
+            bool v = binaryIn ? ((bytes[i >> 3] >> (i & 7)) & 1) != 0 : pins[i] != 0;
+            if (v) row[i] |= bit;
+        }
+
+        if (++filled == BATCH_BLOCKS * 64) {
+            Flush(filled, binaryOut, out);
+            report.vectors += filled;
+            filled = 0;
+        }
+    }
+
+    if (filled > 0) {
+        Flush(filled, binaryOut, out);
+        report.vectors += filled;
+    }
+    out.write(outBuffer.data(), outBuffer.size());
+    outBuffer.clear();
+    if (!out) {
+        error = "write failed: " + resultsPath;
+        return false;
+    }
+
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return true;
+}
+
+// Refill the input buffer; false at end of file
+bool StimulusRunner::Refill(std::ifstream& in) {
+    in.read(inBuffer.data(), inBuffer.size());
+    inPos = 0;
+    inEnd = (size_t)in.gcount();
+    return inEnd > 0;
+}
+
+// Next text line without its terminator; false at end of file
+bool StimulusRunner::ReadLine(std::ifstream& in, std::string& line) {
+    line.clear();
+    bool any = false;
+    for (;;) {
+        if (inPos == inEnd && !Refill(in)) return any;
+        any = true;
+
+        const char* begin = inBuffer.data() + inPos;
+        const char* newline = (const char*)memchr(begin, '\n', inEnd - inPos);
+        if (newline) {
+            line.append(begin, newline);
+            inPos += newline - begin + 1;
+            return true;
+        }
+        line.append(begin, inEnd - inPos);
+        inPos = inEnd;
+    }
+}
+
+// Read exactly count bytes; got reports how many were available
+bool StimulusRunner::ReadBytes(std::ifstream& in, unsigned char* bytes, size_t count, size_t& got) {
+    got = 0;
+    while (got < count) {
+        if (inPos == inEnd && !Refill(in)) return false;
+        size_t take = inEnd - inPos < count - got ? inEnd - inPos : count - got;
+        memcpy(bytes + got, inBuffer.data() + inPos, take);
+        inPos += take;
+        got += take;
+    }
+    return true;
+}
+
+// Evaluate the first `count` vectors of the batch and append their results
+void StimulusRunner::Flush(int count, bool binary, std::ofstream& out) {
+    int inputCount = (int)graph.inputs.size();
+    int outputCount = (int)graph.outputs.size();
+    size_t vectorBytes = (outputCount + 7) / 8;
+
+    for (int block = 0; block * 64 < count; block++) {
+        uint64_t* row = &batch[(size_t)block * inputCount];
+        int lanes = count - block * 64 < 64 ? count - block * 64 : 64;
+        const uint64_t* result = values.data();
+        if (packed.empty()) {
+            for (int i = 0; i < inputCount; i++) values[graph.inputs[i]] = row[i];
+            graph.Evaluate(values.data(), nullptr, pool);
+        }
+        else {
+            EvaluateSequential(row, lanes);
+            result = packed.data();
+        }
+        for (int i = 0; i < inputCount; i++) row[i] = 0;
+
+        if (trace) TraceBlock(block, lanes, result);
+        if (activity) activity->Accumulate(result, lanes);
+        for (int lane = 0; lane < lanes; lane++) {
+            if (binary) {
+                size_t at = outBuffer.size();
+                outBuffer.resize(at + vectorBytes, 0);
+                for (int o = 0; o < outputCount; o++) {
+                    if ((result[graph.outputs[o]] >> lane) & 1) outBuffer[at + (o >> 3)] |= (char)(1 << (o & 7));
+                }
+            }
+            else {
+                for (int o = 0; o < outputCount; o++) {
+                    outBuffer.push_back((result[graph.outputs[o]] >> lane) & 1 ? '1' : '0');
+                }
+                outBuffer.push_back('\n');
+            }
+
+            // Stream out whenever the buffer is full
+            if (outBuffer.size() >= IO_BUFFER_SIZE) {
+                out.write(outBuffer.data(), outBuffer.size());
+                outBuffer.clear();
+            }
+        }
+    }
+    vectorBase += count;
+}
+
+// Evaluate the vectors of one block one at a time, in order, into packed
+void StimulusRunner::EvaluateSequential(const uint64_t* row, int lanes) {
+    int inputCount = (int)graph.inputs.size();
+    int nodeCount = graph.NodeCount();
+    std::fill(packed.begin(), packed.end(), 0);
+
+    // Every lane holds the same vector, so the loop state carried in values
+    // is that of the previous vector
+    for (int lane = 0; lane < lanes; lane++) {
+        for (int i = 0; i < inputCount; i++) {
+            values[graph.inputs[i]] = (row[i] >> lane) & 1 ? ~0ull : 0;
+        }
+        graph.Evaluate(values.data(), nullptr, pool);
+        for (int n = 0; n < nodeCount; n++) packed[n] |= (values[n] & 1) << lane;
+    }
+}
+
+// Queue the value changes of one evaluated block
+void StimulusRunner::TraceBlock(int block, int lanes, const uint64_t* result) {
+    int inputCount = (int)graph.inputs.size();
+    int signalCount = inputCount + (int)graph.outputs.size();
+    long long first = vectorBase + block * 64;
+    uint64_t laneMask = lanes >= 64 ? ~0ull : (1ull << lanes) - 1;
+    traceLast.resize(signalCount, 0);
+
+    // Lanes where any traced signal differs from the previous vector; the
+    // very first vector is always written
+    uint64_t changed = first == 0 ? 1 : 0;
+    for (int s = 0; s < signalCount; s++) {
+        uint64_t word = result[s < inputCount ? graph.inputs[s] : graph.outputs[s - inputCount]];
+        changed |= word ^ ((word << 1) | (traceLast[s] >> 63));
+        traceLast[s] = word;
+    }
+    changed &= laneMask;
+
+    for (int lane = 0; lane < lanes; lane++) {
+        if (!((changed >> lane) & 1)) continue;
+        for (int s = 0; s < signalCount; s++) {
+            trace->Sample(first + lane, s, ((traceLast[s] >> lane) & 1) != 0);
+        }
+    }
+}
\ No newline at end of file
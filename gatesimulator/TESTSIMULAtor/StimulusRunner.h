@@ -0,0 +1,93 @@
+#ifndef STIMULUS_RUNNER_H
+#define STIMULUS_RUNNER_H
+
+#include "LogicGraph.h"
+#include "VcdWriter.h"
+#include "ToggleCounter.h"
+#include "EvaluationPool.h"
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstdint>
+
+// ================================
+// STIMULUS RUNNER CLASS DECLARATION
+// ================================
+// Headless batch simulation of a stimulus file of any length. Vectors are
+// streamed through fixed-size buffers, packed 64 to a word, evaluated a batch
+// at a time and the OUTPUT values streamed to a results file, so memory use
+// does not depend on the number of vectors.
+//
+// A circuit with feedback loops is sequential: each vector sees the loop state
+// left by the one before it. Such a graph is evaluated one vector per pass, in
+// file order, with every lane carrying the same vector, and the results are
+// packed back into lanes for output, tracing and toggle counting.
+//
+// Text files hold one vector per line as 0/1 characters in INPUT gate order
+// (# starts a comment). Files ending in ".bin" hold raw vectors instead: each
+// one is (count + 7) / 8 bytes, bit i of byte i / 8 (LSB first) being input
+// or output i. Results use the same format as their own file name implies.
+class StimulusRunner {
+public:
+    struct Report {
+        long long vectors = 0;
+        double seconds = 0.0;
+    };
+
+    // graph may be optimized; it must outlive the runner
+    explicit StimulusRunner(const LogicGraph& graph);
+
+    // Simulate every vector of stimulusPath and write one result per vector
+    bool Run(const std::string& stimulusPath, const std::string& resultsPath, Report& report, std::string& error);
+
+    // Trace every INPUT then every OUTPUT (signal ids 0.. in that order) into
+    // an open VCD writer, one time unit per vector; nullptr stops tracing
+    void SetTrace(VcdWriter* vcd);
+
+    // Count the transitions of every node over the run (the counter is reset
+    // here); nullptr stops counting
+    void SetActivity(ToggleCounter* counter);
+
+    // Split the wide levels of every evaluation across a thread pool; nullptr
+    // evaluates on the calling thread only
+    void SetPool(EvaluationPool* workers);
+
+    // True if the path names a raw binary vector file
+    static bool IsBinaryPath(const std::string& path);
+
+private:
+    static const int BATCH_BLOCKS = 64;             // 4096 vectors per batch
+    static const size_t IO_BUFFER_SIZE = 1 << 20;
+
+    const LogicGraph& graph;
+    std::vector<uint64_t> values;       // One word per node
+    std::vector<uint64_t> packed;       // Sequential graphs: node values of one block, one lane per vector
+    std::vector<uint64_t> batch;        // batch[block * inputCount + input]
+    std::vector<char> inBuffer;
+    std::vector<char> outBuffer;
+    size_t inPos = 0;
+    size_t inEnd = 0;
+    long long vectorBase = 0;           // Index of the first vector in the batch
+
+    VcdWriter* trace = nullptr;
+    std::vector<uint64_t> traceLast;    // Previous block of each traced signal
+
+    ToggleCounter* activity = nullptr;
+    EvaluationPool* pool = nullptr;
+
+    // Buffered reading
+    bool Refill(std::ifstream& in);
+    bool ReadLine(std::ifstream& in, std::string& line);
+    bool ReadBytes(std::ifstream& in, unsigned char* bytes, size_t count, size_t& got);
+
+    // Evaluate the first `count` vectors of the batch and append their results
+    void Flush(int count, bool binary, std::ofstream& out);
+
+    // Evaluate the vectors of one block one at a time, in order, into packed
+    void EvaluateSequential(const uint64_t* row, int lanes);
+
+    // Queue the value changes of one evaluated block
+    void TraceBlock(int block, int lanes, const uint64_t* result);
+};
+
+#endif // STIMULUS_RUNNER_H
\ No newline at end of file
@@ -0,0 +1,112 @@
+#include "ToggleCounter.h"
+#include "WiringSystem.h"
+#include <fstream>
+#include <algorithm>
+
+// ================================
+// TOGGLE COUNTER CLASS IMPLEMENTATION
+// ================================
+
+// Drop all counts and size for a graph of nodeCount nodes
+void ToggleCounter::Reset(int nodeCount) {
+    counts.assign(nodeCount, 0);
+    lastLane.assign((nodeCount + 63) / 64, 0);
+    lastWord.assign(nodeCount, 0);
+    samples = 0;
+}
+
+// Count the transitions in the first `lanes` lanes of values[]: lane i toggles
+// when it differs from lane i - 1, lane 0 when it differs from the last lane
+// of the previous call. Nodes are taken 64 at a time so their last lanes are
+// read and written as one packed word
+void ToggleCounter::Accumulate(const uint64_t* values, int lanes) {
+    if (lanes <= 0) return;
+    uint64_t laneMask = lanes >= 64 ? ~0ull : (1ull << lanes) - 1;
+    int top = lanes - 1;
+    bool first = samples == 0;
+    int nodeCount = (int)counts.size();
+
+    for (int base = 0; base < nodeCount; base += 64) {
+        uint64_t previous = lastLane[base >> 6];
+        uint64_t next = 0;
+        int end = std::min(base + 64, nodeCount);
+        for (int n = base; n < end; n++) {
+            int bit = n - base;
+            uint64_t word = values[n];
+            uint64_t carry = first ? (word & 1) : ((previous >> bit) & 1);
+            counts[n] += CountBits((word ^ ((word << 1) | carry)) & laneMask);
+            next |= ((word >> top) & 1) << bit;
+        }
+        lastLane[base >> 6] = next;
+    }
+    samples += lanes;
+}
+
+// Count one pattern of a graph with buses: per node, the bits within its
+// width that differ from the previous call; the first call only sets the
+// starting values
+void ToggleCounter::AccumulateBits(const uint64_t* values, const uint8_t* widths) {
+    int nodeCount = (int)counts.size();
+    for (int n = 0; n < nodeCount; n++) {
+        uint64_t word = values[n] & BusMask(widths[n]);
+        if (samples > 0) counts[n] += CountBits(word ^ lastWord[n]);
+        lastWord[n] = word;
+    }
+    samples++;
+}
+
+// Transitions of a node; 0 for a node of another graph or -1
+uint64_t ToggleCounter::GetCount(int node) const {
+    return node >= 0 && node < (int)counts.size() ? counts[node] : 0;
+}
+
+uint64_t ToggleCounter::GetMaxCount() const {
+    uint64_t most = 0;
+    for (uint64_t count : counts) most = std::max(most, count);
+    return most;
+}
+
+uint64_t ToggleCounter::GetSampleCount() const {
+    return samples;
+}
+
+// CSV with one row per gate and per wire; gates optimized out of the graph
+// report no toggles
+bool ToggleCounter::Export(const std::string& path, const LogicGraph& graph,
+    const std::vector<std::unique_ptr<Gate>>& gates, const WiringSystem& wiring, std::string& error) const {
+    std::ofstream out(path);
+    if (!out) {
+        error = "cannot write " + path;
+        return false;
+    }
+
+    double transitions = samples > 1 ? (double)(samples - 1) : 1.0;
+    auto toggles = [&](int gate) {
+        return gate < (int)graph.gateNode.size() ? GetCount(graph.gateNode[gate]) : 0;
+    };
+
+    out << "# toggle activity over " << samples << " vectors\n";
+    out << "kind,gate,type,from,pin,toggles,per_vector\n";
+    for (int g = 0; g < (int)gates.size(); g++) {
+        uint64_t count = toggles(g);
+        out << "gate," << g << "," << GetGateInfo(gates[g]->GetType()).label << ",,,"
+            << count << "," << count / transitions << "\n";
+    }
+
+    // Wires by the gate input they drive
+    for (int g = 0; g < (int)gates.size(); g++) {
+        for (int i = 0; i < gates[g]->GetInputCount(); i++) {
+            const Wire* wire = wiring.GetFaninWire(g, i);
+            if (!wire) continue;
+            uint64_t count = toggles(wire->fromGateIndex);
+            out << "wire," << g << ",," << wire->fromGateIndex << "," << i << ","
+                << count << "," << count / transitions << "\n";
+        }
+    }
+
+    if (!out) {
+        error = "write failed: " + path;
+        return false;
+    }
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#ifndef TOGGLE_COUNTER_H
+#define TOGGLE_COUNTER_H
+
+#include "Gate.h"
+#include "LogicGraph.h"
+#include <vector>
+#include <memory>
+#include <string>
+#include <cstdint>
+
+// Forward declaration to avoid circular dependency
+class WiringSystem;
+
+// ================================
+// TOGGLE COUNTER CLASS DECLARATION
+// ================================
+// Switching activity of every node of a LogicGraph, for dynamic power
+// estimates and hot-spot maps. Each Accumulate() takes the node words right
+// after an evaluation: the transitions between consecutive lanes of a word,
+// and from the last lane of the previous call, are counted with one popcount
+// per node. The last lane of every node is kept as a packed bit array. A
+// wire carries the output of its driving gate, so it toggles with that gate.
+//
+// A graph with buses evaluates one pattern with all bits of a bus in one
+// word, so it is counted with AccumulateBits() instead: every bit of a bus
+// that toggles counts, and a 1-bit node counts as it would in lane 0.
+class ToggleCounter {
+public:
+    // Drop all counts and size for a graph of nodeCount nodes
+    void Reset(int nodeCount);
+
+    // Count the transitions in the first `lanes` lanes of values[] (one word
+    // per node); the very first lane seen only sets the starting values
+    void Accumulate(const uint64_t* values, int lanes);
+
+    // Count one pattern of a graph with buses: the bits of node n that
+    // differ from the previous call, within its widths[n] bits
+    void AccumulateBits(const uint64_t* values, const uint8_t* widths);
+
+    // Transitions of a node; 0 for a node of another graph or -1
+    uint64_t GetCount(int node) const;
+    uint64_t GetMaxCount() const;
+
+    // Vectors (or frames) seen since Reset()
+    uint64_t GetSampleCount() const;
+
+    // CSV with one row per gate and per wire: toggles, and toggles per vector
+    // (bit toggles for a bus)
+    bool Export(const std::string& path, const LogicGraph& graph, const std::vector<std::unique_ptr<Gate>>& gates,
+        const WiringSystem& wiring, std::string& error) const;
+
+private:
+    std::vector<uint64_t> counts;       // One counter per node
+    std::vector<uint64_t> lastLane;     // Bit n: value of node n in the last lane seen
+    std::vector<uint64_t> lastWord;     // AccumulateBits(): last word of every node
+    uint64_t samples = 0;
+};
+
+#endif // TOGGLE_COUNTER_H
\ No newline at end of file
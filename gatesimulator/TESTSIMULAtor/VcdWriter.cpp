@@ -0,0 +1,194 @@
+#include "VcdWriter.h"
+#include <chrono>
+#include <algorithm>
+
+// ================================
+// VCD WRITER CLASS IMPLEMENTATION
+// ================================
+
+// Constructor: capacity is rounded up to a power of two
+VcdWriter::VcdWriter(size_t capacity) : head(0), tail(0), running(false) {
+    size_t size = 2;
+    while (size < capacity) size <<= 1;
+    ring.resize(size);
+}
+
+VcdWriter::~VcdWriter() {
+    Close();
+}
+
+// Declare a signal of `width` bits before Open(); returns its id
+int VcdWriter::AddSignal(const std::string& name, int width) {
+    std::string clean = name;
+    for (char& c : clean) {
+        if (c == ' ' || c == '\t') c = '_';
+    }
+    names.push_back(clean);
+    ids.push_back(IdFor((int)ids.size()));
+    widths.push_back(std::max(1, std::min(width, MAX_BUS_WIDTH)));
+    lastValue.push_back(-1);
+    lastWord.push_back(0);
+    return (int)names.size() - 1;
+}
+
+// Write the header and start the writer thread
+bool VcdWriter::Open(const std::string& path, const std::string& timescale, std::string& error) {
+    Close();
+
+    file.open(path, std::ios::binary);
+    if (!file) {
+        error = "cannot write " + path;
+        return false;
+    }
+
+    file << "$version Logic Gate Simulator $end\n";
+    file << "$timescale " << timescale << " $end\n";
+    file << "$scope module circuit $end\n";
+    for (size_t i = 0; i < names.size(); i++) {
+        file << "$var wire " << widths[i] << " " << ids[i] << " " << names[i];
+        if (widths[i] > 1) file << " [" << widths[i] - 1 << ":0]";
+        file << " $end\n";
+    }
+    file << "$upscope $end\n$enddefinitions $end\n";
+
+    std::fill(lastValue.begin(), lastValue.end(), (signed char)-1);
+    changeCount = 0;
+    head.store(0);
+    tail.store(0);
+    running.store(true);
+    open = true;
+    writer = std::thread(&VcdWriter::Drain, this);
+    return true;
+}
+
+// Record the value of a two-valued signal
+void VcdWriter::Sample(uint64_t time, int signal, bool value) {
+    Sample(time, signal, value ? Logic::ONE : Logic::ZERO);
+}
+
+// Record the value of a signal; unchanged values never reach the ring
+void VcdWriter::Sample(uint64_t time, int signal, Logic value) {
+    if (!open || lastValue[signal] == (signed char)value) return;
+    lastValue[signal] = (signed char)value;
+    Push({ time, 0, (uint32_t)signal, value });
+}
+
+// Record the bits of a bus signal; unchanged values never reach the ring
+void VcdWriter::SampleBus(uint64_t time, int signal, uint64_t value, bool unknown) {
+    Logic level = unknown ? Logic::X : Logic::ONE;
+    value = unknown ? 0 : value & BusMask(widths[signal]);
+    if (!open || (lastValue[signal] == (signed char)level && lastWord[signal] == value)) return;
+    lastValue[signal] = (signed char)level;
+    lastWord[signal] = value;
+    Push({ time, value, (uint32_t)signal, level });
+}
+
+// Queue one change, waiting while the ring is full
+void VcdWriter::Push(const Change& change) {
+    changeCount++;
+
+    size_t h = head.load(std::memory_order_relaxed);
+    while (h - tail.load(std::memory_order_acquire) == ring.size()) {
+        wake.notify_one();
+        std::this_thread::yield();      // Ring full: let the writer catch up
+    }
+
+    ring[h & (ring.size() - 1)] = change;
+    head.store(h + 1, std::memory_order_release);
+
+    // Wake the writer once the ring is half full instead of on every change
+    if (h + 1 - tail.load(std::memory_order_relaxed) == ring.size() / 2) wake.notify_one();
+}
+
+// Flush everything and stop the writer thread
+void VcdWriter::Close() {
+    if (!open) return;
+    running.store(false, std::memory_order_release);
+    wake.notify_one();
+    writer.join();
+    file.close();
+    open = false;
+}
+
+bool VcdWriter::IsOpen() const {
+    return open;
+}
+
+size_t VcdWriter::GetSignalCount() const {
+    return names.size();
+}
+
+uint64_t VcdWriter::GetChangeCount() const {
+    return changeCount;
+}
+
+// Writer thread: format queued changes until Close()
+void VcdWriter::Drain() {
+    std::string out;
+    out.reserve(1 << 16);
+    uint64_t lastTime = ~0ull;
+    size_t mask = ring.size() - 1;
+    const char* levelChars = "z10x";    // Indexed by Logic
+
+    for (;;) {
+        bool stopping = !running.load(std::memory_order_acquire);
+        size_t h = head.load(std::memory_order_acquire);
+        size_t t = tail.load(std::memory_order_relaxed);
+        bool idle = (t == h);
+
+        while (t != h) {
+            const Change& change = ring[t & mask];
+            if (change.time != lastTime) {
+                out += '#';
+                out += std::to_string(change.time);
+                out += '\n';
+                lastTime = change.time;
+            }
+            if (widths[change.signal] == 1) {
+                out += levelChars[(int)change.value];
+            }
+            else if (change.value == Logic::X) {
+                out += "bx ";
+            }
+            else {
+                // Binary without leading zeros, as VCD allows
+                out += 'b';
+                int bit = 63;
+                while (bit > 0 && !((change.word >> bit) & 1)) bit--;
+                for (; bit >= 0; bit--) out += (change.word >> bit) & 1 ? '1' : '0';
+                out += ' ';
+            }
+            out += ids[change.signal];
+            out += '\n';
+            t++;
+
+            if (out.size() >= (1 << 16)) {
+                tail.store(t, std::memory_order_release);
+                file.write(out.data(), out.size());
+                out.clear();
+            }
+        }
+        tail.store(t, std::memory_order_release);
+
+        if (stopping || idle) {
+            file.write(out.data(), out.size());
+            out.clear();
+        }
+        if (stopping) break;
+        if (idle) {
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            wake.wait_for(lock, std::chrono::milliseconds(5));
+        }
+    }
+    file.flush();
+}
+
+// Short printable identifier for signal n (base 94 over '!'..'~')
+std::string VcdWriter::IdFor(int n) {
+    std::string id;
+    do {
+        id += (char)('!' + n % 94);
+        n /= 94;
+    } while (n > 0);
+    return id;
+}
\ No newline at end of file
@@ -0,0 +1,88 @@
+#ifndef VCD_WRITER_H
+#define VCD_WRITER_H
+
+#include "Constants.h"
+#include <vector>
+#include <string>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <fstream>
+#include <cstdint>
+
+// ================================
+// VCD WRITER CLASS DECLARATION
+// ================================
+// Value Change Dump of single-bit signals, in 0/1 or, for four-valued
+// simulation, 0/1/x/z, and of buses of up to 64 bits, dumped as binary
+// vectors (all x while any bit is unknown). The simulation thread calls
+// Sample() for every traced signal; only changes are queued, into a
+// preallocated single-producer ring buffer that a background thread formats
+// and writes to disk. When the ring is full the producer waits for the
+// writer rather than dropping changes.
+class VcdWriter {
+public:
+    explicit VcdWriter(size_t capacity = 1 << 16);
+    ~VcdWriter();
+
+    // Declare a signal of `width` bits before Open(); returns its id
+    int AddSignal(const std::string& name, int width = 1);
+
+    // Write the header and start the writer thread; timescale e.g. "1 ms"
+    bool Open(const std::string& path, const std::string& timescale, std::string& error);
+
+    // Record the value of a signal at a (non-decreasing) time
+    void Sample(uint64_t time, int signal, bool value);
+    void Sample(uint64_t time, int signal, Logic value);
+
+    // Record the bits of a bus signal; unknown dumps it as all x
+    void SampleBus(uint64_t time, int signal, uint64_t value, bool unknown);
+
+    // Flush everything and stop the writer thread
+    void Close();
+
+    bool IsOpen() const;
+    size_t GetSignalCount() const;
+    uint64_t GetChangeCount() const;
+
+private:
+    // A bus change has value X when it is unknown, otherwise ONE with its
+    // bits in word
+    struct Change {
+        uint64_t time;
+        uint64_t word;
+        uint32_t signal;
+        Logic value;
+    };
+
+    std::vector<std::string> names;
+    std::vector<std::string> ids;           // VCD identifier codes
+    std::vector<int> widths;                // Bits of each signal
+    std::vector<signed char> lastValue;     // Producer side: a Logic, -1 = not sampled yet
+    std::vector<uint64_t> lastWord;         // Producer side: last bits of a bus
+    uint64_t changeCount = 0;
+
+    // Ring buffer: the producer owns head, the writer thread owns tail
+    std::vector<Change> ring;
+    std::atomic<size_t> head;
+    std::atomic<size_t> tail;
+
+    std::ofstream file;
+    std::thread writer;
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    std::atomic<bool> running;
+    bool open = false;
+
+    // Queue one change, waiting while the ring is full
+    void Push(const Change& change);
+
+    // Writer thread: format queued changes until Close()
+    void Drain();
+
+    // Short printable identifier for signal n
+    static std::string IdFor(int n);
+};
+
+#endif // VCD_WRITER_H
\ No newline at end of file
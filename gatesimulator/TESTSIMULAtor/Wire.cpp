@@ -1,5 +1,6 @@
 #include "Wire.h"
 #include "Gate.h"
+#include "GateGrid.h"
 #include <algorithm>
 #include <cmath>
 
@@ -23,7 +24,7 @@ void Wire::CalculateSimpleLRoute(Vector2 start, Vector2 end) {
 }
 
 // Helper function to check distance from point to line segment
-float Wire::DistanceToLineSegment(Vector2 point, Vector2 lineStart, Vector2 lineEnd) const {
+float Wire::DistanceToLineSegment(Vector2 point, Vector2 lineStart, Vector2 lineEnd) {
     Vector2 line = Vector2Subtract(lineEnd, lineStart);
     Vector2 pointToStart = Vector2Subtract(point, lineStart);
 
@@ -39,41 +40,53 @@ float Wire::DistanceToLineSegment(Vector2 point, Vector2 lineStart, Vector2 line
     return Vector2Distance(point, projection);
 }
 
+// One segment as 8 px dashes with 6 px gaps
+void Wire::DrawDashedSegment(GeometryBatch& shapes, Vector2 start, Vector2 end, Color color) {
+    float length = Vector2Distance(start, end);
+    if (length == 0) return;
+    Vector2 step = Vector2Scale(Vector2Subtract(end, start), 1.0f / length);
+
+    for (float at = 0; at < length; at += 14.0f) {
+        float stop = std::min(at + 8.0f, length);
+        shapes.AddSegment(Vector2Add(start, Vector2Scale(step, at)), Vector2Add(start, Vector2Scale(step, stop)), 3.0f, color);
+    }
+}
+
 // Calculate route that avoids gates
-Vector2 Wire::CalculateAvoidanceRoute(Vector2 start, Vector2 end, const std::vector<std::unique_ptr<Gate>>& gates, float clearance) const {
+Vector2 Wire::CalculateAvoidanceRoute(Vector2 start, Vector2 end, const std::vector<std::unique_ptr<Gate>>& gates, float clearance, const GateGrid* grid) const {
     float dx = end.x - start.x;
     float dy = end.y - start.y;
 
     // Try horizontal-first routing with different percentages
-    std::vector<float> percentages = { 0.5f, 0.7f, 0.3f, 0.8f, 0.2f };
+    static const float percentages[] = { 0.5f, 0.7f, 0.3f, 0.8f, 0.2f };
 
     for (float pct : percentages) {
         Vector2 horizontalRoute = { start.x + dx * pct, start.y };
-        if (!DoesRouteIntersectGates(start, horizontalRoute, { horizontalRoute.x, end.y }, end, gates, clearance)) {
+        if (!DoesRouteIntersectGates(start, horizontalRoute, { horizontalRoute.x, end.y }, end, gates, clearance, grid)) {
             return horizontalRoute;
         }
 
         // Try vertical-first routing with same percentage
         Vector2 verticalRoute = { start.x, start.y + dy * pct };
-        if (!DoesRouteIntersectGates(start, verticalRoute, { end.x, verticalRoute.y }, end, gates, clearance)) {
+        if (!DoesRouteIntersectGates(start, verticalRoute, { end.x, verticalRoute.y }, end, gates, clearance, grid)) {
             return verticalRoute;
         }
     }
 
     // Try going around obstacles with smaller offsets first
-    std::vector<float> offsets = { 30.0f, 60.0f, 100.0f, -30.0f, -60.0f, -100.0f };
+    static const float offsets[] = { 30.0f, 60.0f, 100.0f, -30.0f, -60.0f, -100.0f };
 
     for (float offset : offsets) {
         for (float pct : percentages) {
             // Try horizontal-first with offset
             Vector2 candidate = { start.x + dx * pct, start.y + offset };
-            if (!DoesRouteIntersectGates(start, candidate, { candidate.x, end.y }, end, gates, clearance)) {
+            if (!DoesRouteIntersectGates(start, candidate, { candidate.x, end.y }, end, gates, clearance, grid)) {
                 return candidate;
             }
 
             // Try vertical-first with offset
             candidate = { start.x + offset, start.y + dy * pct };
-            if (!DoesRouteIntersectGates(start, candidate, { end.x, candidate.y }, end, gates, clearance)) {
+            if (!DoesRouteIntersectGates(start, candidate, { end.x, candidate.y }, end, gates, clearance, grid)) {
                 return candidate;
             }
         }
@@ -84,15 +97,28 @@ Vector2 Wire::CalculateAvoidanceRoute(Vector2 start, Vector2 end, const std::vec
 
 // Check if the L-route intersects with any gates
 bool Wire::DoesRouteIntersectGates(Vector2 p1, Vector2 p2, Vector2 p3, Vector2 p4,
-    const std::vector<std::unique_ptr<Gate>>& gates, float clearance) const {
+    const std::vector<std::unique_ptr<Gate>>& gates, float clearance, const GateGrid* grid) const {
     // Check each segment of the route
-    return DoesLineIntersectGates(p1, p2, gates, clearance) ||
-        DoesLineIntersectGates(p2, p3, gates, clearance) ||
-        DoesLineIntersectGates(p3, p4, gates, clearance);
+    return DoesLineIntersectGates(p1, p2, gates, clearance, grid) ||
+        DoesLineIntersectGates(p2, p3, gates, clearance, grid) ||
+        DoesLineIntersectGates(p3, p4, gates, clearance, grid);
 }
 
 // Check if a line segment intersects with any gates
-bool Wire::DoesLineIntersectGates(Vector2 start, Vector2 end, const std::vector<std::unique_ptr<Gate>>& gates, float clearance) const {
+bool Wire::DoesLineIntersectGates(Vector2 start, Vector2 end, const std::vector<std::unique_ptr<Gate>>& gates, float clearance, const GateGrid* grid) const {
+    if (grid) {
+        // Expanding the line bounds by the clearance is the same test as expanding every gate
+        Rectangle area = {
+            std::min(start.x, end.x) - clearance,
+            std::min(start.y, end.y) - clearance,
+            std::abs(end.x - start.x) + 1.0f + 2 * clearance,
+            std::abs(end.y - start.y) + 1.0f + 2 * clearance
+        };
+        const Gate* from = fromGateIndex >= 0 && fromGateIndex < (int)gates.size() ? gates[fromGateIndex].get() : nullptr;
+        const Gate* to = toGateIndex >= 0 && toGateIndex < (int)gates.size() ? gates[toGateIndex].get() : nullptr;
+        return grid->Overlaps(area, from, to);
+    }
+
     for (int i = 0; i < gates.size(); i++) {
         // Skip the source and destination gates
         if (i == fromGateIndex || i == toGateIndex) continue;
@@ -122,38 +148,24 @@ bool Wire::DoesLineIntersectGates(Vector2 start, Vector2 end, const std::vector<
 }
 
 // Find alternative route around obstacles
-Vector2 Wire::FindAvoidanceRoute(Vector2 start, Vector2 end, const std::vector<std::unique_ptr<Gate>>& gates, float clearance) const {
+Vector2 Wire::FindAvoidanceRoute(Vector2 start, Vector2 end, const std::vector<std::unique_ptr<Gate>>& gates, float clearance, const GateGrid* grid) const {
     float dx = end.x - start.x;
     float dy = end.y - start.y;
 
-    // Find the gates that are blocking the direct path
-    std::vector<Rectangle> obstacles;
-    for (int i = 0; i < gates.size(); i++) {
-        if (i == fromGateIndex || i == toGateIndex) continue;
-
-        Rectangle gateBounds = gates[i]->GetBounds();
-        Rectangle expandedBounds = {
-            gateBounds.x - clearance,
-            gateBounds.y - clearance,
-            gateBounds.width + 2 * clearance,
-            gateBounds.height + 2 * clearance
-        };
-        obstacles.push_back(expandedBounds);
-    }
-
     // Try going around obstacles by adjusting the intermediate point
-    std::vector<float> offsets = { 50.0f, 100.0f, 150.0f, -50.0f, -100.0f, -150.0f };
+    // (DoesRouteIntersectGates checks the expanded gate bounds itself)
+    static const float offsets[] = { 50.0f, 100.0f, 150.0f, -50.0f, -100.0f, -150.0f };
 
     for (float offset : offsets) {
         // Try horizontal-first with offset
         Vector2 candidate = { start.x + dx * 0.7f, start.y + offset };
-        if (!DoesRouteIntersectGates(start, candidate, { candidate.x, end.y }, end, gates, clearance)) {
+        if (!DoesRouteIntersectGates(start, candidate, { candidate.x, end.y }, end, gates, clearance, grid)) {
             return candidate;
         }
 
         // Try vertical-first with offset
         candidate = { start.x + offset, start.y + dy * 0.7f };
-        if (!DoesRouteIntersectGates(start, candidate, { end.x, candidate.y }, end, gates, clearance)) {
+        if (!DoesRouteIntersectGates(start, candidate, { end.x, candidate.y }, end, gates, clearance, grid)) {
             return candidate;
         }
     }
@@ -3,6 +3,8 @@
 
 #include "raylib.h"
 #include "raymath.h"
+#include "Constants.h"
+#include "GeometryBatch.h"
 #include <vector>
 #include <memory>
 #include <algorithm>
@@ -10,6 +12,7 @@
 
 // Forward declaration to avoid circular dependency
 class Gate;
+class GateGrid;
 
 // ================================
 // WIRE CLASS DECLARATION
@@ -21,6 +24,15 @@ public:
     int toGateIndex;
     int toInputIndex;
     bool state = false;
+    Logic level = Logic::ZERO;      // Four-valued state (X only in four-valued mode)
+    int width = 1;                  // Bits carried, from the driving gate
+    uint64_t busValue = 0;          // All bits of a bus wire
+
+    // Position in the owning WiringSystem's wire list (for O(1) removal)
+    int slot = -1;
+
+    // Position in the owning WiringSystem's reroute queue, -1 if not queued
+    int routeSlot = -1;
 
     // L-routing waypoints
     std::vector<Vector2> waypoints;
@@ -31,7 +43,10 @@ public:
     }
 
     // Calculate L-shaped route between two points with gate avoidance
-    void CalculateLRoute(Vector2 start, Vector2 end, const std::vector<std::unique_ptr<Gate>>* gates = nullptr) {
+    // (waypoints keeps its capacity, so rerouting every frame does not allocate);
+    // with a grid, only the gates near each candidate segment are tested
+    void CalculateLRoute(Vector2 start, Vector2 end, const std::vector<std::unique_ptr<Gate>>* gates = nullptr,
+        const GateGrid* grid = nullptr) {
         waypoints.clear();
         waypoints.push_back(start);
 
@@ -48,7 +63,7 @@ public:
         const float CLEARANCE = 5.0f; // Minimal clearance - much less aggressive
 
         // Try different routing strategies
-        Vector2 bestRoute = CalculateAvoidanceRoute(start, end, *gates, CLEARANCE);
+        Vector2 bestRoute = CalculateAvoidanceRoute(start, end, *gates, CLEARANCE, grid);
 
         if (bestRoute.x != -1) {
             // Use the calculated avoidance route
@@ -64,24 +79,39 @@ public:
         waypoints.push_back(end);
     }
 
-    // Draw the wire with L-routing
-    void Draw(Color wireColor) const {
+    // Draw the wire with L-routing into the shape batch of the frame; an
+    // unknown (X or Z) wire is dashed, a bus is drawn once, thicker
+    void Draw(GeometryBatch& shapes, Color wireColor) const {
         if (waypoints.size() < 2) return;
+        bool unknown = level == Logic::X || level == Logic::Z;
+        float thickness = width > 1 ? 6.0f : 3.0f;
 
         // Draw line segments between waypoints
         for (size_t i = 0; i < waypoints.size() - 1; i++) {
-            DrawLineEx(waypoints[i], waypoints[i + 1], 3.0f, wireColor);
+            if (unknown) {
+                DrawDashedSegment(shapes, waypoints[i], waypoints[i + 1], wireColor);
+            }
+            else {
+                shapes.AddSegment(waypoints[i], waypoints[i + 1], thickness, wireColor);
+            }
         }
 
         // Draw connection points
         if (!waypoints.empty()) {
-            DrawCircleV(waypoints.front(), 3, wireColor);
-            DrawCircleV(waypoints.back(), 3, wireColor);
+            shapes.AddCircle(waypoints.front(), 3, wireColor);
+            shapes.AddCircle(waypoints.back(), 3, wireColor);
         }
 
         // Draw corner points
         for (size_t i = 1; i < waypoints.size() - 1; i++) {
-            DrawCircleV(waypoints[i], 2, wireColor);
+            shapes.AddCircle(waypoints[i], width > 1 ? 3 : 2, wireColor);
+        }
+    }
+
+    // Width of a bus by its driver, drawn after the shapes
+    void DrawLabel() const {
+        if (width > 1 && !waypoints.empty()) {
+            DrawText(TextFormat("%i", width), waypoints.front().x + 6, waypoints.front().y - 16, 10, DARKGRAY);
         }
     }
 
@@ -99,7 +129,13 @@ public:
         return false;
     }
 
+    // Distance from a point to a line segment
+    static float DistanceToLineSegment(Vector2 point, Vector2 lineStart, Vector2 lineEnd);
+
 private:
+    // One segment as 8 px dashes with 6 px gaps
+    static void DrawDashedSegment(GeometryBatch& shapes, Vector2 start, Vector2 end, Color color);
+
     // Simple L-routing without gate avoidance
     void CalculateSimpleLRoute(Vector2 start, Vector2 end);
 
@@ -107,20 +143,17 @@ private:
     bool DoesLineIntersectRect(Vector2 start, Vector2 end, Rectangle rect) const;
 
     // Calculate route that avoids gates
-    Vector2 CalculateAvoidanceRoute(Vector2 start, Vector2 end, const std::vector<std::unique_ptr<Gate>>& gates, float clearance) const;
+    Vector2 CalculateAvoidanceRoute(Vector2 start, Vector2 end, const std::vector<std::unique_ptr<Gate>>& gates, float clearance, const GateGrid* grid) const;
 
     // Check if the L-route intersects with any gates
     bool DoesRouteIntersectGates(Vector2 p1, Vector2 p2, Vector2 p3, Vector2 p4,
-        const std::vector<std::unique_ptr<Gate>>& gates, float clearance) const;
+        const std::vector<std::unique_ptr<Gate>>& gates, float clearance, const GateGrid* grid) const;
 
     // Check if a line segment intersects with any gates
-    bool DoesLineIntersectGates(Vector2 start, Vector2 end, const std::vector<std::unique_ptr<Gate>>& gates, float clearance) const;
+    bool DoesLineIntersectGates(Vector2 start, Vector2 end, const std::vector<std::unique_ptr<Gate>>& gates, float clearance, const GateGrid* grid) const;
 
     // Find alternative route around obstacles
-    Vector2 FindAvoidanceRoute(Vector2 start, Vector2 end, const std::vector<std::unique_ptr<Gate>>& gates, float clearance) const;
-
-    // Helper function to check distance from point to line segment
-    float DistanceToLineSegment(Vector2 point, Vector2 lineStart, Vector2 lineEnd) const;
+    Vector2 FindAvoidanceRoute(Vector2 start, Vector2 end, const std::vector<std::unique_ptr<Gate>>& gates, float clearance, const GateGrid* grid) const;
 };
 
 #endif // WIRE_H
\ No newline at end of file
@@ -1,30 +1,32 @@
 #include "WiringSystem.h"
+#include "EditHistory.h"
 #include <algorithm>
+#include <cmath>
+
+// Smallest rectangle covering both
+static Rectangle CoverBounds(Rectangle a, Rectangle b) {
+    float left = std::min(a.x, b.x);
+    float top = std::min(a.y, b.y);
+    float right = std::max(a.x + a.width, b.x + b.width);
+    float bottom = std::max(a.y + a.height, b.y + b.height);
+    return { left, top, right - left, bottom - top };
+}
 
 // ================================
 // WIRING SYSTEM CLASS IMPLEMENTATION
 // ================================
 
-// Find connection point near mouse position
-ConnectionPoint* WiringSystem::FindConnectionPoint(Vector2 mousePos, const std::vector<std::unique_ptr<Gate>>& gates) {
-    static ConnectionPoint foundPoint({ 0, 0 }, false, -1);
-
-    for (int i = 0; i < gates.size(); i++) {
-        auto points = gates[i]->GetConnectionPoints(i);
-        for (const auto& point : points) {
-            float distance = Vector2Distance(mousePos, point.position);
-            if (distance <= CONNECTION_SNAP_DISTANCE) {
-                foundPoint = point;
-                return &foundPoint;
-            }
-        }
-    }
-    return nullptr;
+// Gate, pin and wire under a point
+PickResult WiringSystem::Pick(Vector2 point, const std::vector<std::unique_ptr<Gate>>& gates) {
+    RouteWires(gates);
+    return picker.Pick(point, GetSceneVersion(), gates, segmentHash);
 }
 
 // Handle wire creation
 bool WiringSystem::HandleWireClick(Vector2 mousePos, const std::vector<std::unique_ptr<Gate>>& gates) {
-    ConnectionPoint* clickedPoint = FindConnectionPoint(mousePos, gates);
+    SyncGateSlots(gates);
+    PickResult pick = Pick(mousePos, gates);
+    const ConnectionPoint* clickedPoint = pick.hasPin ? &pick.pin : nullptr;
 
     if (!clickedPoint) {
         // Clicked empty space, cancel wire creation
@@ -48,25 +50,10 @@ bool WiringSystem::HandleWireClick(Vector2 mousePos, const std::vector<std::uniq
         // Complete wire creation - must click on input point
         if (clickedPoint->isInput && clickedPoint->gateIndex != wireSourceGate) {
             // Check if this input is already connected
-            bool alreadyConnected = false;
-            for (const auto& wire : wires) {
-                if (wire->toGateIndex == clickedPoint->gateIndex &&
-                    wire->toInputIndex == clickedPoint->inputIndex) {
-                    alreadyConnected = true;
-                    break;
-                }
-            }
-
-            if (!alreadyConnected) {
-                // Create the wire
-                auto newWire = std::make_unique<Wire>(wireSourceGate, clickedPoint->gateIndex, clickedPoint->inputIndex);
+            bool alreadyConnected = IsInputConnected(clickedPoint->gateIndex, clickedPoint->inputIndex);
 
-                // Calculate L-route with gate avoidance for the new wire
-                Vector2 startPos = gates[wireSourceGate]->GetOutputPoint();
-                Vector2 endPos = gates[clickedPoint->gateIndex]->GetInputPoint(clickedPoint->inputIndex);
-                newWire->CalculateLRoute(startPos, endPos, &gates);
-
-                wires.push_back(std::move(newWire));
+            if (!alreadyConnected && CanConnect(*gates[wireSourceGate], *gates[clickedPoint->gateIndex])) {
+                ConnectWire(wireSourceGate, clickedPoint->gateIndex, clickedPoint->inputIndex, gates);
             }
         }
 
@@ -79,76 +66,175 @@ bool WiringSystem::HandleWireClick(Vector2 mousePos, const std::vector<std::uniq
     return false;
 }
 
+// A wire joins equal widths, except into a SPLIT or MERGE, which take any bus
+bool WiringSystem::CanConnect(const Gate& from, const Gate& to) {
+    return from.GetWidth() == to.GetWidth() || to.GetType() == GateType::SPLIT || to.GetType() == GateType::MERGE;
+}
+
 // Handle wire deletion
 bool WiringSystem::HandleWireDeletion(Vector2 mousePos, const std::vector<std::unique_ptr<Gate>>& gates) {
-    // Find wire close to mouse position using the new IsNearWirePath method
-    for (int i = 0; i < wires.size(); i++) {
-        if (wires[i]->IsNearWirePath(mousePos, 10.0f)) {
-            wires.erase(wires.begin() + i);
-            return true;
-        }
-    }
-    return false;
+    // Find the wire closest to the mouse position through the segment hash
+    PickResult pick = Pick(mousePos, gates);
+    if (pick.wireGate == -1) return false;
+
+    DisconnectWire(GetFaninWire(pick.wireGate, pick.wireInput));
+    return true;
 }
 
 // Update wire states and propagate signals
 void WiringSystem::UpdateSignals(std::vector<std::unique_ptr<Gate>>& gates) {
-    // First, compute outputs for INPUT gates only (they don't depend on inputs)
-    for (auto& gate : gates) {
-        if (gate->GetType() == GateType::INPUT) {
-            gate->ComputeOutput();
-        }
-        else {
-            // Reset inputs for non-INPUT gates
-            gate->input1 = false;
-            gate->input2 = false;
-        }
-    }
+    SyncGateSlots(gates);
+
+    EvaluateCompiled(gates);
 
-    // Propagate signals through wires
+    // Final pass: Update wire states
     for (auto& wire : wires) {
         if (wire->fromGateIndex < gates.size() && wire->toGateIndex < gates.size()) {
-            // Get the current output state from source gate
-            bool signal = gates[wire->fromGateIndex]->output;
-            wire->state = signal;  // Update wire visual state
+            wire->state = gates[wire->fromGateIndex]->output;
+            wire->level = gates[wire->fromGateIndex]->outputLevel;
+        }
+    }
+
+    RouteWires(gates);
+}
+
+// Recalculate routes with gate avoidance, for the queued wires and the wires
+// crossing an area a gate appeared in; a block edit is routed in one pass
+void WiringSystem::RouteWires(const std::vector<std::unique_ptr<Gate>>& gates) {
+    for (const Rectangle& area : dirtyAreas) {
+        crossing.clear();
+        segmentHash.Collect(area, crossing);
+        for (Wire* wire : crossing) QueueRoute(wire);
+    }
+    dirtyAreas.clear();
 
-            // Apply signal to destination gate input
-            if (wire->toInputIndex == 0) {
-                gates[wire->toGateIndex]->input1 = signal;
+    for (Wire* wire : unrouted) {
+        if (!wire) continue;
+        wire->routeSlot = -1;
+        RouteWire(wire, gates);
+    }
+    unrouted.clear();
+}
+
+// Queue a wire for routing (once)
+void WiringSystem::QueueRoute(Wire* wire) {
+    if (wire->routeSlot >= 0) return;
+    wire->routeSlot = (int)unrouted.size();
+    unrouted.push_back(wire);
+}
+
+// Route one wire and file its segments
+void WiringSystem::RouteWire(Wire* wire, const std::vector<std::unique_ptr<Gate>>& gates) {
+    segmentHash.Remove(wire);
+    if (wire->fromGateIndex < gates.size() && wire->toGateIndex < gates.size()) {
+        Vector2 startPos = gates[wire->fromGateIndex]->GetOutputPoint();
+        Vector2 endPos = gates[wire->toGateIndex]->GetInputPoint(wire->toInputIndex);
+        wire->CalculateLRoute(startPos, endPos, &gates, &gateGrid);
+        segmentHash.Insert(wire);
+    }
+}
+
+// Evaluate the compiled graph and copy the values back to the gates
+void WiringSystem::EvaluateCompiled(std::vector<std::unique_ptr<Gate>>& gates) {
+    if (compiledVersion != structureVersion || compiledGraph.gateNode.size() != gates.size()) {
+        LogicGraph raw;
+        raw.Build(gates, *this);
+        // The optimizer rewrites 1-bit logic; circuits with buses run as drawn
+        if (optimizedEvaluation && !fourValued && !raw.hasBuses) {
+            compiledGraph = LogicOptimizer::Optimize(raw, &optimizerStats);
+        }
+        else {
+            compiledGraph = std::move(raw);
+        }
+        LocalityOrder::Apply(compiledGraph, &localityStats);
+        compiledVersion = structureVersion;
+        if (!evaluationPool && compiledGraph.widestLevel >= PARALLEL_MIN_LEVEL_NODES &&
+            std::thread::hardware_concurrency() > 1) {
+            evaluationPool = std::make_unique<EvaluationPool>();
+        }
+
+        // Loops (latches) resume from the values currently shown; four-valued,
+        // a gate that has not been evaluated yet starts out X
+        if (fourValued) {
+            nodeValues.assign(2 * compiledGraph.NodeCount(), 0);
+            for (int g = 0; g < (int)gates.size(); g++) {
+                int node = compiledGraph.gateNode[g];
+                Logic level = gates[g]->outputLevel == Logic::Z ? Logic::X : gates[g]->outputLevel;
+                if (node < 0) continue;
+                if (gates[g]->IsBus() && level != Logic::X) {
+                    nodeValues[2 * node] = gates[g]->busValue;
+                    nodeValues[2 * node + 1] = ~gates[g]->busValue;
+                    continue;
+                }
+                nodeValues[2 * node] = ((int)level & 1) ? ~0ull : 0;
+                nodeValues[2 * node + 1] = ((int)level & 2) ? ~0ull : 0;
             }
-            else if (wire->toInputIndex == 1) {
-                gates[wire->toGateIndex]->input2 = signal;
+        }
+        else {
+            nodeValues.assign(compiledGraph.NodeCount(), 0);
+            for (int g = 0; g < (int)gates.size(); g++) {
+                int node = compiledGraph.gateNode[g];
+                if (node < 0) continue;
+                nodeValues[node] = gates[g]->IsBus() ? gates[g]->busValue : gates[g]->output ? ~0ull : 0;
             }
         }
+        loopUnstable.assign(compiledGraph.loops.size(), 0);
+        activity.Reset(compiledGraph.NodeCount());
     }
 
-    // Now compute outputs for all non-INPUT gates with their updated inputs
+    // INPUT nodes follow gate order; a bus INPUT holds its switch word
+    size_t next = 0;
     for (auto& gate : gates) {
-        if (gate->GetType() != GateType::INPUT) {
-            gate->ComputeOutput();
+        if (gate->GetType() != GateType::INPUT) continue;
+        int node = compiledGraph.inputs[next++];
+        uint64_t value = gate->IsBus() ? gate->busValue : gate->inputs[0] ? ~0ull : 0;
+        if (fourValued) {
+            nodeValues[2 * node] = value;
+            nodeValues[2 * node + 1] = ~value;
+        }
+        else {
+            nodeValues[node] = value;
         }
     }
 
-    // Final pass: Update wire states and recalculate routes with gate avoidance if gates have moved
-    for (auto& wire : wires) {
-        if (wire->fromGateIndex < gates.size() && wire->toGateIndex < gates.size()) {
-            wire->state = gates[wire->fromGateIndex]->output;
+    if (fourValued) {
+        compiledGraph.Evaluate4(nodeValues.data(), loopUnstable.data(), evaluationPool.get());
+        compiledGraph.WriteBack4(nodeValues.data(), 0, gates, *this);
+    }
+    else {
+        compiledGraph.Evaluate(nodeValues.data(), loopUnstable.data(), evaluationPool.get());
+        if (compiledGraph.hasBuses) activity.AccumulateBits(nodeValues.data(), compiledGraph.widths.data());
+        else activity.Accumulate(nodeValues.data(), 1);
+        compiledGraph.WriteBack(nodeValues.data(), 0, gates, *this);
+    }
 
-            // Recalculate route with gate avoidance in case gates have moved
-            Vector2 startPos = gates[wire->fromGateIndex]->GetOutputPoint();
-            Vector2 endPos = gates[wire->toGateIndex]->GetInputPoint(wire->toInputIndex);
-            wire->CalculateLRoute(startPos, endPos, &gates);
-        }
+    // Flag the gates of every loop that is still oscillating
+    oscillatingLoops = 0;
+    for (unsigned char u : loopUnstable) oscillatingLoops += u;
+    for (int g = 0; g < (int)gates.size(); g++) {
+        int node = compiledGraph.gateNode[g];
+        int loop = node >= 0 ? compiledGraph.loopOf[node] : -1;
+        gates[g]->oscillating = loop >= 0 && loopUnstable[loop];
     }
 }
 
-// Draw all wires
-void WiringSystem::DrawWires(const std::vector<std::unique_ptr<Gate>>& gates, Vector2 mousePos) {
+// Draw all wires into the shape batch of the frame
+void WiringSystem::DrawWires(const std::vector<std::unique_ptr<Gate>>& gates, Vector2 mousePos, GeometryBatch& shapes) {
+    // Heat map: blue (quiet) through yellow to red (the most toggles so far)
+    float hottest = heatMap ? (float)activity.GetMaxCount() : 0.0f;
+
     // Draw existing wires using their L-routing
     for (const auto& wire : wires) {
         if (wire->fromGateIndex < gates.size() && wire->toGateIndex < gates.size()) {
-            Color wireColor = wire->state ? RED : DARKGRAY;
-            wire->Draw(wireColor);
+            Color wireColor = wire->level == Logic::X ? ORANGE : wire->state ? RED : DARKGRAY;
+            if (heatMap) {
+                int node = wire->fromGateIndex < (int)compiledGraph.gateNode.size() ? compiledGraph.gateNode[wire->fromGateIndex] : -1;
+                float heat = hottest > 0.0f ? (float)activity.GetCount(node) / hottest : 0.0f;
+                wireColor = heat < 0.5f
+                    ? Color{ (unsigned char)(510 * heat), (unsigned char)(510 * heat), (unsigned char)(255 * (1.0f - 2 * heat)), 255 }
+                    : Color{ 255, (unsigned char)(255 * (2.0f - 2 * heat)), 0, 255 };
+            }
+            wire->Draw(shapes, wireColor);
         }
     }
 
@@ -156,66 +242,574 @@ void WiringSystem::DrawWires(const std::vector<std::unique_ptr<Gate>>& gates, Ve
     if (isCreatingWire && wireSourceGate >= 0 && wireSourceGate < gates.size()) {
         Vector2 startPos = gates[wireSourceGate]->GetOutputPoint();
 
-        // Create temporary wire for preview with gate avoidance
-        Wire tempWire(wireSourceGate, -1, 0);
-        tempWire.CalculateLRoute(startPos, mousePos, &gates);
-        tempWire.Draw(YELLOW);
+        // Reuse the preview wire (and its waypoint storage) with gate avoidance
+        previewWire.fromGateIndex = wireSourceGate;
+        previewWire.CalculateLRoute(startPos, mousePos, &gates, &gateGrid);
+        previewWire.Draw(shapes, YELLOW);
+    }
+}
+
+// Bus widths by the wires, drawn once the shapes have been submitted
+void WiringSystem::DrawWireLabels() const {
+    for (const auto& wire : wires) {
+        wire->DrawLabel();
+    }
+    if (isCreatingWire) {
+        previewWire.DrawLabel();
     }
 }
 
 // Highlight connection points when in wiring mode
 void WiringSystem::HighlightConnectionPoints(const std::vector<std::unique_ptr<Gate>>& gates, Vector2 mousePos) {
-    ConnectionPoint* nearbyPoint = FindConnectionPoint(mousePos, gates);
-
-    for (int i = 0; i < gates.size(); i++) {
-        auto points = gates[i]->GetConnectionPoints(i);
-        for (const auto& point : points) {
-            bool isNearby = (nearbyPoint && nearbyPoint->gateIndex == point.gateIndex &&
-                nearbyPoint->inputIndex == point.inputIndex &&
-                nearbyPoint->isInput == point.isInput);
-
-            if (isNearby) {
-                Color highlightColor = YELLOW;
-                if (isCreatingWire) {
-                    // Show valid/invalid connections
-                    if (point.isInput && point.gateIndex != wireSourceGate) {
-                        // Check if already connected
-                        bool alreadyConnected = false;
-                        for (const auto& wire : wires) {
-                            if (wire->toGateIndex == point.gateIndex &&
-                                wire->toInputIndex == point.inputIndex) {
-                                alreadyConnected = true;
-                                break;
-                            }
-                        }
-                        highlightColor = alreadyConnected ? RED : GREEN;
-                    }
-                    else {
-                        highlightColor = RED; // Invalid connection
-                    }
-                }
+    // Only the point under the mouse is highlighted, so no second pass over every gate is needed
+    PickResult pick = Pick(mousePos, gates);
+    if (!pick.hasPin) return;
 
-                DrawCircleV(point.position, CONNECTION_POINT_RADIUS + 3, highlightColor);
-            }
+    const ConnectionPoint& point = pick.pin;
+    Color highlightColor = YELLOW;
+    if (isCreatingWire) {
+        // Show valid/invalid connections
+        if (point.isInput && point.gateIndex != wireSourceGate) {
+            bool alreadyConnected = IsInputConnected(point.gateIndex, point.inputIndex);
+            highlightColor = alreadyConnected ? RED : GREEN;
+        }
+        else {
+            highlightColor = RED; // Invalid connection
         }
     }
+
+    DrawCircleV(point.position, CONNECTION_POINT_RADIUS + 3, highlightColor);
 }
 
 // Remove wires connected to a gate (when gate is deleted)
 void WiringSystem::RemoveWiresForGate(int gateIndex) {
-    wires.erase(
-        std::remove_if(wires.begin(), wires.end(),
-            [gateIndex](const std::unique_ptr<Wire>& wire) {
-                return wire->fromGateIndex == gateIndex || wire->toGateIndex == gateIndex;
-            }),
-        wires.end()
-    );
+    if (gateIndex < 0 || gateIndex >= (int)fanout.size()) return;
+
+    // Copy first: DisconnectWire edits these lists while we walk them
+    std::vector<Wire*> attached = fanout[gateIndex];
+    for (Wire* wire : fanin[gateIndex]) {
+        if (wire) attached.push_back(wire);
+    }
+
+    for (Wire* wire : attached) {
+        DisconnectWire(wire);
+    }
 }
 
-// Update wire indices when gates are rearranged
-void WiringSystem::UpdateWireIndices(int removedIndex) {
-    for (auto& wire : wires) {
-        if (wire->fromGateIndex > removedIndex) wire->fromGateIndex--;
-        if (wire->toGateIndex > removedIndex) wire->toGateIndex--;
+// Append a newly placed gate
+int WiringSystem::AddGate(std::unique_ptr<Gate> gate, std::vector<std::unique_ptr<Gate>>& gates) {
+    int gateIndex = (int)gates.size();
+    if (history) {
+        history->Record(EditDelta::Place(gateIndex, *gate));
+    }
+    InsertGate(gateIndex, std::move(gate), gates);
+    return gateIndex;
+}
+
+// Move a gate; its wires, the wires it now blocks and cached picks follow the new layout
+void WiringSystem::MoveGate(int gateIndex, Vector2 position, std::vector<std::unique_ptr<Gate>>& gates) {
+    SyncGateSlots(gates);
+    Gate* gate = gates[gateIndex].get();
+    if (gate->position.x == position.x && gate->position.y == position.y) return;
+
+    gateGrid.Remove(gate);
+    gate->position = position;
+    gateGrid.Insert(gate);
+    dirtyAreas.push_back(gate->GetBounds());
+    layoutVersion++;
+
+    for (Wire* wire : fanout[gateIndex]) QueueRoute(wire);
+    for (Wire* wire : fanin[gateIndex]) {
+        if (wire) QueueRoute(wire);
+    }
+}
+
+// True if a gate could be placed here without overlapping another
+bool WiringSystem::IsAreaFree(Rectangle area) const {
+    return !gateGrid.Overlaps(area);
+}
+
+// Copy the listed gates and the wires between them
+void WiringSystem::CopyBlock(const std::vector<int>& gateIndices, const std::vector<std::unique_ptr<Gate>>& gates,
+    CircuitBlock& block) const {
+    block.gates.clear();
+    block.wires.clear();
+    block.size = { 0, 0 };
+    if (gateIndices.empty()) return;
+
+    Vector2 low = { INFINITY, INFINITY };
+    Vector2 high = { -INFINITY, -INFINITY };
+    for (int g : gateIndices) {
+        Rectangle bounds = gates[g]->GetBounds();
+        low = { std::min(low.x, bounds.x), std::min(low.y, bounds.y) };
+        high = { std::max(high.x, bounds.x + bounds.width), std::max(high.y, bounds.y + bounds.height) };
+    }
+    block.size = { high.x - low.x, high.y - low.y };
+
+    // Block-local index of every gate, -1 outside the block
+    std::vector<int> local(gates.size(), -1);
+    for (int g : gateIndices) {
+        const Gate& gate = *gates[g];
+        local[g] = (int)block.gates.size();
+        block.gates.push_back({ gate.GetType(), gate.GetInputCount(), gate.GetWidth(), gate.GetSliceOffset(),
+            gate.GetType() == GateType::INPUT ? gate.GetSwitchValue() : 0,
+            { gate.position.x - low.x, gate.position.y - low.y } });
+    }
+
+    for (int g : gateIndices) {
+        for (int i = 0; i < (int)fanin[g].size(); i++) {
+            Wire* wire = fanin[g][i];
+            if (wire && local[wire->fromGateIndex] >= 0) {
+                block.wires.push_back({ local[wire->fromGateIndex], local[g], i });
+            }
+        }
+    }
+}
+
+// Insert a block as one batch: a single overlap check of all its gates, then
+// the gates and wires are appended and routed together at the next routing
+bool WiringSystem::InsertBlock(const CircuitBlock& block, Vector2 origin, std::vector<std::unique_ptr<Gate>>& gates) {
+    SyncGateSlots(gates);
+    if (block.IsEmpty()) return false;
+
+    std::vector<std::unique_ptr<Gate>> fresh;
+    fresh.reserve(block.gates.size());
+    Rectangle extent = { 0, 0, 0, 0 };
+    for (const CircuitBlock::GateCopy& copy : block.gates) {
+        Vector2 position = { origin.x + copy.offset.x, origin.y + copy.offset.y };
+        fresh.push_back(std::make_unique<Gate>(copy.type, position, copy.inputCount, copy.width, copy.sliceOffset));
+        if (copy.type == GateType::INPUT) fresh.back()->SetSwitchValue(copy.state);
+        Rectangle bounds = fresh.back()->GetBounds();
+        if (gateGrid.Overlaps(bounds)) return false;
+        extent = fresh.size() == 1 ? bounds : CoverBounds(extent, bounds);
+    }
+
+    int first = (int)gates.size();
+    gates.reserve(gates.size() + fresh.size());
+    fanin.reserve(fanin.size() + fresh.size());
+    fanout.reserve(fanout.size() + fresh.size());
+    wires.reserve(wires.size() + block.wires.size());
+
+    // Append every gate, then account for the whole block at once: one dirty
+    // area over its extent and one version bump
+    if (history) history->BeginStep();
+    isCreatingWire = false;
+    wireSourceGate = -1;
+    for (auto& gate : fresh) {
+        if (history) history->Record(EditDelta::Place((int)gates.size(), *gate));
+        gateGrid.Insert(gate.get());
+        fanin.emplace_back(gate->GetInputCount(), nullptr);
+        fanout.emplace_back();
+        gates.push_back(std::move(gate));
+    }
+    dirtyAreas.push_back(extent);
+    structureVersion++;
+    layoutVersion++;
+
+    for (const CircuitBlock::WireCopy& copy : block.wires) {
+        ConnectWire(first + copy.fromGate, first + copy.toGate, copy.toInput, gates);
+    }
+    if (history) history->EndStep();
+    return true;
+}
+
+// Move many gates by the same offset as one batch: the extent of the block
+// before and after the move are the only dirty areas, and every wire on the
+// moved gates is queued for routing once
+void WiringSystem::MoveGates(const std::vector<int>& gateIndices, Vector2 offset, std::vector<std::unique_ptr<Gate>>& gates) {
+    SyncGateSlots(gates);
+    if (gateIndices.empty() || (offset.x == 0 && offset.y == 0)) return;
+
+    Rectangle before = gates[gateIndices[0]]->GetBounds();
+    for (int g : gateIndices) {
+        Gate* gate = gates[g].get();
+        before = CoverBounds(before, gate->GetBounds());
+        gateGrid.Remove(gate);
+        gate->position = { gate->position.x + offset.x, gate->position.y + offset.y };
+        gateGrid.Insert(gate);
+    }
+    Rectangle after = { before.x + offset.x, before.y + offset.y, before.width, before.height };
+    dirtyAreas.push_back(before);
+    dirtyAreas.push_back(after);
+    layoutVersion++;
+
+    for (int g : gateIndices) {
+        for (Wire* wire : fanout[g]) QueueRoute(wire);
+        for (Wire* wire : fanin[g]) {
+            if (wire) QueueRoute(wire);
+        }
+    }
+}
+
+// Remove many gates as one undo step. Highest index first: the gate swapped
+// into a freed slot is then never one that still has to go
+void WiringSystem::RemoveGates(std::vector<int> gateIndices, std::vector<std::unique_ptr<Gate>>& gates) {
+    std::sort(gateIndices.begin(), gateIndices.end());
+    gateIndices.erase(std::unique(gateIndices.begin(), gateIndices.end()), gateIndices.end());
+
+    if (history) history->BeginStep();
+    for (auto it = gateIndices.rbegin(); it != gateIndices.rend(); ++it) {
+        RemoveGate(*it, gates);
+    }
+    if (history) history->EndStep();
+}
+
+// Put a gate back at a given slot; the current occupant moves to the end
+void WiringSystem::InsertGate(int gateIndex, std::unique_ptr<Gate> gate, std::vector<std::unique_ptr<Gate>>& gates) {
+    SyncGateSlots(gates);
+    isCreatingWire = false;
+    wireSourceGate = -1;
+
+    structureVersion++;
+    layoutVersion++;
+    gateGrid.Insert(gate.get());
+    dirtyAreas.push_back(gate->GetBounds());
+    fanin.emplace_back(gate->GetInputCount(), nullptr);
+    fanout.emplace_back();
+    gates.push_back(std::move(gate));
+
+    int last = (int)gates.size() - 1;
+    if (gateIndex < last) {
+        SwapGates(gateIndex, last, gates);
     }
+}
+
+// Delete a gate and its wires; the last gate takes over the freed slot
+void WiringSystem::RemoveGate(int gateIndex, std::vector<std::unique_ptr<Gate>>& gates) {
+    SyncGateSlots(gates);
+    if (gateIndex < 0 || gateIndex >= (int)gates.size()) return;
+    isCreatingWire = false;
+    wireSourceGate = -1;
+
+    if (history) history->BeginStep();
+    RemoveWiresForGate(gateIndex);
+    if (history) {
+        const Gate& gate = *gates[gateIndex];
+        history->Record(EditDelta::Remove(gateIndex, gate));
+        history->EndStep();
+    }
+
+    int last = (int)gates.size() - 1;
+    if (gateIndex < last) {
+        SwapGates(gateIndex, last, gates);
+    }
+    gateGrid.Remove(gates.back().get());
+    gates.pop_back();
+    fanin.pop_back();
+    fanout.pop_back();
+    structureVersion++;
+    layoutVersion++;
+}
+
+// Create and route a wire from a gate output to a free input
+Wire* WiringSystem::ConnectWire(int fromGate, int toGate, int toInput, const std::vector<std::unique_ptr<Gate>>& gates) {
+    SyncGateSlots(gates);
+    if (IsInputConnected(toGate, toInput)) return nullptr;
+
+    // The L-route is computed by UpdateSignals before the wire is first drawn,
+    // so bulk loads and headless runs never pay for routing
+    auto newWire = std::make_unique<Wire>(fromGate, toGate, toInput);
+    newWire->width = gates[fromGate]->GetWidth();
+
+    if (history) {
+        history->Record(EditDelta::Connect(fromGate, toGate, toInput));
+    }
+
+    Wire* wire = newWire.get();
+    wire->slot = (int)wires.size();
+    LinkWire(wire);
+    wires.push_back(std::move(newWire));
+    QueueRoute(wire);
+    return wire;
+}
+
+// Delete a single wire
+void WiringSystem::DisconnectWire(Wire* wire) {
+    if (!wire) return;
+    if (history) {
+        history->Record(EditDelta::Disconnect(wire->fromGateIndex, wire->toGateIndex, wire->toInputIndex));
+    }
+    EraseWire(wire);
+}
+
+// Drop every gate and wire
+void WiringSystem::Clear(std::vector<std::unique_ptr<Gate>>& gates) {
+    wires.clear();
+    unrouted.clear();
+    dirtyAreas.clear();
+    segmentHash.Clear();
+    gateGrid.Clear();
+    fanin.clear();
+    fanout.clear();
+    gates.clear();
+    isCreatingWire = false;
+    wireSourceGate = -1;
+    structureVersion++;
+}
+
+// Snapshot the node words and INPUT switches of the current circuit
+void WiringSystem::SaveCheckpoint(Checkpoint& checkpoint, std::vector<std::unique_ptr<Gate>>& gates) {
+    SyncGateSlots(gates);
+    if (compiledVersion != structureVersion || compiledGraph.gateNode.size() != gates.size()) {
+        EvaluateCompiled(gates);
+    }
+
+    checkpoint.fingerprint = GetFingerprint(gates);
+    checkpoint.optimized = optimizedEvaluation;
+    checkpoint.fourValued = fourValued;
+    checkpoint.nodeValues = nodeValues;
+    checkpoint.switches.clear();
+    for (auto& gate : gates) {
+        if (gate->GetType() == GateType::INPUT) checkpoint.switches.push_back(gate->GetSwitchValue());
+    }
+}
+
+// Put a snapshot back; the gates and wires show it immediately
+bool WiringSystem::RestoreCheckpoint(const Checkpoint& checkpoint, std::vector<std::unique_ptr<Gate>>& gates,
+    std::string& error) {
+    SyncGateSlots(gates);
+    if (checkpoint.IsEmpty()) {
+        error = "no checkpoint taken";
+        return false;
+    }
+    if (checkpoint.fingerprint != GetFingerprint(gates)) {
+        error = "checkpoint belongs to a different circuit";
+        return false;
+    }
+    if (checkpoint.optimized != optimizedEvaluation) {
+        error = checkpoint.optimized ? "checkpoint was taken with optimized evaluation"
+            : "checkpoint was taken without optimized evaluation";
+        return false;
+    }
+    if (checkpoint.fourValued != fourValued) {
+        error = checkpoint.fourValued ? "checkpoint was taken with four-valued evaluation"
+            : "checkpoint was taken with two-valued evaluation";
+        return false;
+    }
+    if (compiledVersion != structureVersion || compiledGraph.gateNode.size() != gates.size()) {
+        EvaluateCompiled(gates);
+    }
+    if (checkpoint.nodeValues.size() != nodeValues.size()) {
+        error = "checkpoint does not match the compiled circuit";
+        return false;
+    }
+
+    nodeValues = checkpoint.nodeValues;
+    size_t next = 0;
+    for (auto& gate : gates) {
+        if (gate->GetType() == GateType::INPUT) gate->SetSwitchValue(checkpoint.switches[next++]);
+    }
+    if (fourValued) {
+        compiledGraph.WriteBack4(nodeValues.data(), 0, gates, *this);
+    }
+    else {
+        compiledGraph.WriteBack(nodeValues.data(), 0, gates, *this);
+    }
+    return true;
+}
+
+// FNV-1a over gate types, pin counts and the driver of every pin
+uint64_t WiringSystem::GetFingerprint(const std::vector<std::unique_ptr<Gate>>& gates) {
+    if (fingerprintVersion == structureVersion) return fingerprint;
+
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](uint64_t value) {
+        hash ^= value;
+        hash *= 1099511628211ull;
+    };
+
+    mix(gates.size());
+    for (int g = 0; g < (int)gates.size(); g++) {
+        mix((uint64_t)gates[g]->GetType());
+        mix((uint64_t)gates[g]->GetInputCount());
+        if (gates[g]->IsBus() || gates[g]->GetType() == GateType::SPLIT) {
+            mix((uint64_t)gates[g]->GetWidth() | (uint64_t)gates[g]->GetSliceOffset() << 8);
+        }
+        for (int i = 0; i < gates[g]->GetInputCount(); i++) {
+            Wire* wire = GetFaninWire(g, i);
+            mix(wire ? (uint64_t)wire->fromGateIndex : ~0ull);
+        }
+    }
+
+    fingerprint = hash;
+    fingerprintVersion = structureVersion;
+    return fingerprint;
+}
+
+// Route structural edits into an undo journal
+void WiringSystem::AttachHistory(EditHistory* journal) {
+    history = journal;
+}
+
+// Changes whenever gates or wires are added or removed
+unsigned int WiringSystem::GetStructureVersion() const {
+    return structureVersion;
+}
+
+// Structural and layout changes both advance the scene version
+unsigned int WiringSystem::GetSceneVersion() const {
+    return structureVersion + layoutVersion;
+}
+
+// Evaluate through the optimized netlist instead of gate by gate
+void WiringSystem::SetOptimizedEvaluation(bool enabled) {
+    optimizedEvaluation = enabled;
+    if (enabled) fourValued = false;
+    compiledVersion = structureVersion - 1;  // Force a rebuild
+}
+
+bool WiringSystem::IsOptimizedEvaluation() const {
+    return optimizedEvaluation;
+}
+
+const LogicOptimizer::Stats& WiringSystem::GetOptimizerStats() const {
+    return optimizerStats;
+}
+
+// Wires sorted by destination gate and pin, so drawing and write-back visit
+// them in gate order; the recompile lays the nodes out in evaluation order
+const LocalityOrder::Stats& WiringSystem::ReorderForLocality(std::vector<std::unique_ptr<Gate>>& gates) {
+    SyncGateSlots(gates);
+    std::sort(wires.begin(), wires.end(), [](const std::unique_ptr<Wire>& a, const std::unique_ptr<Wire>& b) {
+        if (a->toGateIndex != b->toGateIndex) return a->toGateIndex < b->toGateIndex;
+        return a->toInputIndex < b->toInputIndex;
+    });
+    for (int i = 0; i < (int)wires.size(); i++) wires[i]->slot = i;
+
+    compiledVersion = structureVersion - 1;  // Force a rebuild
+    EvaluateCompiled(gates);
+    return localityStats;
+}
+
+const LocalityOrder::Stats& WiringSystem::GetLocalityStats() const {
+    return localityStats;
+}
+
+// Evaluate 0/1/X/Z over two bit-planes; the optimizer assumes two-valued
+// logic, so the two modes exclude each other
+void WiringSystem::SetFourValued(bool enabled) {
+    fourValued = enabled;
+    if (enabled) optimizedEvaluation = false;
+    compiledVersion = structureVersion - 1;  // Force a rebuild
+}
+
+bool WiringSystem::IsFourValued() const {
+    return fourValued;
+}
+
+// Colour wires by toggle count instead of state
+void WiringSystem::SetHeatMap(bool enabled) {
+    heatMap = enabled;
+}
+
+bool WiringSystem::IsHeatMap() const {
+    return heatMap;
+}
+
+const ToggleCounter& WiringSystem::GetActivity() const {
+    return activity;
+}
+
+// Write the toggle counts of the compiled circuit as CSV
+bool WiringSystem::ExportActivity(const std::string& path, const std::vector<std::unique_ptr<Gate>>& gates,
+    std::string& error) const {
+    return activity.Export(path, compiledGraph, gates, *this, error);
+}
+
+int WiringSystem::GetLoopCount() const {
+    return (int)compiledGraph.loops.size();
+}
+
+int WiringSystem::GetOscillatingLoopCount() const {
+    return oscillatingLoops;
+}
+
+// ================================
+// ADJACENCY INDEX
+// ================================
+
+// Grow the adjacency index to cover newly placed gates
+void WiringSystem::SyncGateSlots(const std::vector<std::unique_ptr<Gate>>& gates) {
+    for (size_t g = fanin.size(); g < gates.size(); g++) {
+        fanin.emplace_back(gates[g]->GetInputCount(), nullptr);
+        fanout.emplace_back();
+        gateGrid.Insert(gates[g].get());
+        dirtyAreas.push_back(gates[g]->GetBounds());
+        structureVersion++;
+    }
+}
+
+// Register a wire in the adjacency index
+void WiringSystem::LinkWire(Wire* wire) {
+    structureVersion++;
+    fanin[wire->toGateIndex][wire->toInputIndex] = wire;
+    fanout[wire->fromGateIndex].push_back(wire);
+}
+
+// Unregister a wire from the adjacency index
+void WiringSystem::UnlinkWire(Wire* wire) {
+    structureVersion++;
+    std::vector<Wire*>& slots = fanin[wire->toGateIndex];
+    if (wire->toInputIndex < (int)slots.size() && slots[wire->toInputIndex] == wire) {
+        slots[wire->toInputIndex] = nullptr;
+    }
+
+    std::vector<Wire*>& out = fanout[wire->fromGateIndex];
+    auto it = std::find(out.begin(), out.end(), wire);
+    if (it != out.end()) {
+        *it = out.back();
+        out.pop_back();
+    }
+}
+
+// Remove a wire in O(1) by swapping it with the last one
+void WiringSystem::EraseWire(Wire* wire) {
+    UnlinkWire(wire);
+    segmentHash.Remove(wire);
+
+    if (wire->routeSlot >= 0) {
+        unrouted[wire->routeSlot] = nullptr;
+    }
+
+    int slot = wire->slot;
+    if (slot != (int)wires.size() - 1) {
+        std::swap(wires[slot], wires.back());
+        wires[slot]->slot = slot;
+    }
+    wires.pop_back();
+}
+
+// Exchange two gate slots and renumber their wires in O(degree)
+void WiringSystem::SwapGates(int a, int b, std::vector<std::unique_ptr<Gate>>& gates) {
+    if (a == b) return;
+
+    // Each endpoint field is touched exactly once, so wires between a and b stay correct
+    for (Wire* wire : fanout[a]) wire->fromGateIndex = b;
+    for (Wire* wire : fanout[b]) wire->fromGateIndex = a;
+    for (Wire* wire : fanin[a]) if (wire) wire->toGateIndex = b;
+    for (Wire* wire : fanin[b]) if (wire) wire->toGateIndex = a;
+
+    std::swap(fanin[a], fanin[b]);
+    std::swap(fanout[a], fanout[b]);
+    std::swap(gates[a], gates[b]);
+}
+
+// Check if an input already has a driver
+bool WiringSystem::IsInputConnected(int gateIndex, int inputIndex) const {
+    return GetFaninWire(gateIndex, inputIndex) != nullptr;
+}
+
+// Wire driving a given input, or nullptr
+Wire* WiringSystem::GetFaninWire(int gateIndex, int inputIndex) const {
+    if (gateIndex < 0 || gateIndex >= (int)fanin.size()) return nullptr;
+    const std::vector<Wire*>& slots = fanin[gateIndex];
+    if (inputIndex < 0 || inputIndex >= (int)slots.size()) return nullptr;
+    return slots[inputIndex];
+}
+
+// Wires leaving a gate's output
+const std::vector<Wire*>& WiringSystem::GetFanoutWires(int gateIndex) const {
+    static const std::vector<Wire*> none;
+    if (gateIndex < 0 || gateIndex >= (int)fanout.size()) return none;
+    return fanout[gateIndex];
 }
\ No newline at end of file
@@ -5,8 +5,23 @@
 #include "Constants.h"
 #include "Gate.h"
 #include "Wire.h"
+#include "LogicGraph.h"
+#include "LogicOptimizer.h"
+#include "LocalityOrder.h"
+#include "EvaluationPool.h"
+#include "PickService.h"
+#include "SegmentHash.h"
+#include "GateGrid.h"
+#include "CircuitBlock.h"
+#include "Checkpoint.h"
+#include "ToggleCounter.h"
 #include <vector>
 #include <memory>
+#include <string>
+#include <cstdint>
+
+// Forward declaration to avoid circular dependency
+class EditHistory;
 
 // ================================
 // WIRING SYSTEM CLASS DECLARATION
@@ -18,9 +33,93 @@ private:
     int wireSourceGate = -1;
     Vector2 tempWireEnd = { 0, 0 };
 
+    // Per-frame scratch, reused so a steady-state frame allocates nothing
+    Wire previewWire{ -1, -1, 0 };
+
+    // Hover / click hit-testing, cached per mouse position and scene version
+    PickService picker;
+
+    // Routed wire segments by grid cell, kept in step with the routes
+    SegmentHash segmentHash;
+
+    // Gate bounds by grid cell, for placement checks and the router
+    GateGrid gateGrid;
+
+    // Optional undo journal that receives every structural edit
+    EditHistory* history = nullptr;
+
+    // Adjacency index, one entry per gate:
+    // fanin[g][i] is the wire driving input i of gate g (nullptr if unconnected),
+    // fanout[g] lists every wire leaving the output of gate g
+    std::vector<std::vector<Wire*>> fanin;
+    std::vector<std::vector<Wire*>> fanout;
+
+    // Bumped on every structural change; compiled graphs are rebuilt when it moves
+    unsigned int structureVersion = 0;
+
+    // Bumped whenever a gate is placed, moved or removed (invalidates cached picks)
+    unsigned int layoutVersion = 0;
+
+    // Wires waiting to be routed: new ones and those of moved gates (nullptr
+    // entries were removed while queued). Where a gate appeared or moved to,
+    // the wires crossing that area are queued at the next routing; removed
+    // gates and wires leave every other route as it is
+    std::vector<Wire*> unrouted;
+    std::vector<Rectangle> dirtyAreas;
+    std::vector<Wire*> crossing;        // Scratch for area queries
+
+    // Queue a wire for routing (once)
+    void QueueRoute(Wire* wire);
+
+    // Route one wire and file its segments
+    void RouteWire(Wire* wire, const std::vector<std::unique_ptr<Gate>>& gates);
+
+    // Levelized evaluation through a compiled LogicGraph, rebuilt (and its loops
+    // re-detected) only when the structure changes; optionally optimized first,
+    // or four-valued with two words (bit-planes) per node in nodeValues. Its
+    // nodes are always renumbered in evaluation order (LocalityOrder)
+    bool optimizedEvaluation = false;
+    bool fourValued = false;
+    unsigned int compiledVersion = ~0u;
+    LogicGraph compiledGraph;
+    LogicOptimizer::Stats optimizerStats;
+    LocalityOrder::Stats localityStats;
+    std::unique_ptr<EvaluationPool> evaluationPool;     // Started once a level is wide enough to split
+    std::vector<uint64_t> nodeValues;
+    std::vector<unsigned char> loopUnstable;    // Per loop of compiledGraph: did not settle
+    int oscillatingLoops = 0;
+
+    // Transitions of every compiled node since the structure last changed,
+    // one lane per frame (two-valued evaluation only); drawn as a heat map on request
+    ToggleCounter activity;
+    bool heatMap = false;
+
+    // Hash of gate types and connections, cached per structure version
+    uint64_t fingerprint = 0;
+    unsigned int fingerprintVersion = ~0u;
+
+    // Evaluate the compiled graph and copy the values back to the gates
+    void EvaluateCompiled(std::vector<std::unique_ptr<Gate>>& gates);
+
+    // Identify the circuit structure a checkpoint belongs to
+    uint64_t GetFingerprint(const std::vector<std::unique_ptr<Gate>>& gates);
+
+    // Grow the adjacency index to cover newly placed gates
+    void SyncGateSlots(const std::vector<std::unique_ptr<Gate>>& gates);
+
+    // Register / unregister a wire in the adjacency index
+    void LinkWire(Wire* wire);
+    void UnlinkWire(Wire* wire);
+
+    // Remove a wire in O(1) by swapping it with the last one (its segments leave the hash)
+    void EraseWire(Wire* wire);
+
+    // Exchange two gate slots and renumber their wires in O(degree)
+    void SwapGates(int a, int b, std::vector<std::unique_ptr<Gate>>& gates);
+
 public:
-    // Find connection point near mouse position
-    ConnectionPoint* FindConnectionPoint(Vector2 mousePos, const std::vector<std::unique_ptr<Gate>>& gates);
+    // Gate, pin and wire under a point (wires are routed first if the layout changed)
+    PickResult Pick(Vector2 point, const std::vector<std::unique_ptr<Gate>>& gates);
 
     // Handle wire creation
     bool HandleWireClick(Vector2 mousePos, const std::vector<std::unique_ptr<Gate>>& gates);
@@ -31,8 +130,14 @@ public:
     // Update wire states and propagate signals
     void UpdateSignals(std::vector<std::unique_ptr<Gate>>& gates);
 
-    // Draw all wires
-    void DrawWires(const std::vector<std::unique_ptr<Gate>>& gates, Vector2 mousePos);
+    // Route every queued wire and every wire crossing an area where a gate appeared
+    void RouteWires(const std::vector<std::unique_ptr<Gate>>& gates);
+
+    // Draw all wires into the shape batch of the frame
+    void DrawWires(const std::vector<std::unique_ptr<Gate>>& gates, Vector2 mousePos, GeometryBatch& shapes);
+
+    // Bus widths by the wires, drawn once the shapes have been submitted
+    void DrawWireLabels() const;
 
     // Highlight connection points when in wiring mode
     void HighlightConnectionPoints(const std::vector<std::unique_ptr<Gate>>& gates, Vector2 mousePos);
@@ -40,8 +145,80 @@ public:
     // Remove wires connected to a gate (when gate is deleted)
     void RemoveWiresForGate(int gateIndex);
 
-    // Update wire indices when gates are rearranged
-    void UpdateWireIndices(int removedIndex);
+    // Gate lifecycle; removal swaps the last gate into the freed slot
+    int AddGate(std::unique_ptr<Gate> gate, std::vector<std::unique_ptr<Gate>>& gates);
+    void MoveGate(int gateIndex, Vector2 position, std::vector<std::unique_ptr<Gate>>& gates);
+    void InsertGate(int gateIndex, std::unique_ptr<Gate> gate, std::vector<std::unique_ptr<Gate>>& gates);
+    void RemoveGate(int gateIndex, std::vector<std::unique_ptr<Gate>>& gates);
+
+    // True if a gate could be placed here without overlapping another
+    bool IsAreaFree(Rectangle area) const;
+
+    // Block operations, each applied as one batch and recorded as one undo
+    // step: copy the listed gates and the wires between them; insert a block
+    // with its top-left corner at origin (false, and nothing changes, if any
+    // of its gates would overlap an existing gate); move or remove many gates
+    void CopyBlock(const std::vector<int>& gateIndices, const std::vector<std::unique_ptr<Gate>>& gates,
+        CircuitBlock& block) const;
+    bool InsertBlock(const CircuitBlock& block, Vector2 origin, std::vector<std::unique_ptr<Gate>>& gates);
+    void MoveGates(const std::vector<int>& gateIndices, Vector2 offset, std::vector<std::unique_ptr<Gate>>& gates);
+    void RemoveGates(std::vector<int> gateIndices, std::vector<std::unique_ptr<Gate>>& gates);
+
+    // Wire lifecycle; a wire takes the width of its driver, and the editor
+    // only joins pins CanConnect() accepts
+    static bool CanConnect(const Gate& from, const Gate& to);
+    Wire* ConnectWire(int fromGate, int toGate, int toInput, const std::vector<std::unique_ptr<Gate>>& gates);
+    void DisconnectWire(Wire* wire);
+
+    // Drop every gate and wire
+    void Clear(std::vector<std::unique_ptr<Gate>>& gates);
+
+    // Route structural edits into an undo journal (nullptr to stop recording)
+    void AttachHistory(EditHistory* journal);
+
+    // Changes whenever gates or wires are added or removed
+    unsigned int GetStructureVersion() const;
+
+    // Changes whenever gates or wires are added, removed or moved
+    unsigned int GetSceneVersion() const;
+
+    // Evaluate through the optimized netlist instead of gate by gate
+    void SetOptimizedEvaluation(bool enabled);
+    bool IsOptimizedEvaluation() const;
+    const LogicOptimizer::Stats& GetOptimizerStats() const;
+
+    // Sort the wire list by destination pin and recompile, which renumbers
+    // the evaluation nodes in evaluation order; the stats model the cache
+    // misses of one evaluation before and after
+    const LocalityOrder::Stats& ReorderForLocality(std::vector<std::unique_ptr<Gate>>& gates);
+    const LocalityOrder::Stats& GetLocalityStats() const;
+
+    // Evaluate 0/1/X/Z: unconnected pins float (Z, read as X) and new latches
+    // start out X. Turns optimized evaluation off, and the other way round
+    void SetFourValued(bool enabled);
+    bool IsFourValued() const;
+
+    // Snapshot every signal of the current circuit, and put one back (fails if
+    // the circuit or the evaluation mode differs from when it was taken)
+    void SaveCheckpoint(Checkpoint& checkpoint, std::vector<std::unique_ptr<Gate>>& gates);
+    bool RestoreCheckpoint(const Checkpoint& checkpoint, std::vector<std::unique_ptr<Gate>>& gates, std::string& error);
+
+    // Switching activity since the last structural change: colour wires by
+    // toggle count instead of state, and write the counts as CSV
+    void SetHeatMap(bool enabled);
+    bool IsHeatMap() const;
+    const ToggleCounter& GetActivity() const;
+    bool ExportActivity(const std::string& path, const std::vector<std::unique_ptr<Gate>>& gates, std::string& error) const;
+
+    // Combinational loops found in the current circuit, and how many of them
+    // failed to settle in the last evaluation
+    int GetLoopCount() const;
+    int GetOscillatingLoopCount() const;
+
+    // Adjacency queries, O(1) / O(degree)
+    bool IsInputConnected(int gateIndex, int inputIndex) const;
+    Wire* GetFaninWire(int gateIndex, int inputIndex) const;
+    const std::vector<Wire*>& GetFanoutWires(int gateIndex) const;
 };
 
 #endif // WIRING_SYSTEM_H
\ No newline at end of file
@@ -4,20 +4,239 @@
 #include "Gate.h"
 #include "Sidebar.h"
 #include "WiringSystem.h"
+#include "EditHistory.h"
+#include "CircuitFile.h"
+#include "FaultSimulator.h"
+#include "StimulusRunner.h"
+#include "CircuitTrace.h"
+#include "Selection.h"
+#include "BatchRunner.h"
+#include "AllocationCounter.h"
+#include "LogicOptimizer.h"
+#include "InputTape.h"
+#include "FrameStats.h"
+#include "GeometryBatch.h"
 #include <iostream>
 #include <vector>
 #include <memory>
 #include <string>
+#include <cstdlib>
+#include <algorithm>
 
 using namespace std;
 
+// Replace the circuit with a .bench file; loading is not part of the undo history
+static void LoadCircuit(const string& path, vector<unique_ptr<Gate>>& gates, WiringSystem& wiringSystem, EditHistory& history) {
+    string error;
+    wiringSystem.AttachHistory(nullptr);
+    if (!CircuitFile::LoadBench(path, gates, wiringSystem, error)) {
+        // The current circuit is untouched, so its undo history stays valid
+        cerr << "Load failed: " << error << endl;
+        wiringSystem.AttachHistory(&history);
+        return;
+    }
+    wiringSystem.ReorderForLocality(gates);
+    wiringSystem.AttachHistory(&history);
+    history.Clear();
+}
+
+// Headless stuck-at fault grading: --faults circuit.bench [vectors.txt | random:N]...
+static int RunFaultGrading(int argc, char** argv) {
+    vector<unique_ptr<Gate>> gates;
+    WiringSystem wiringSystem;
+    string error;
+    if (argc < 3 || !CircuitFile::LoadBench(argv[2], gates, wiringSystem, error)) {
+        cerr << (argc < 3 ? "usage: --faults circuit.bench [vectors.txt | random:N]..." : error) << endl;
+        return 1;
+    }
+
+    LogicGraph graph;
+    graph.Build(gates, wiringSystem);
+    FaultSimulator simulator(graph);
+    cout << "Circuit: " << argv[2] << " (" << gates.size() << " gates, "
+        << simulator.GetFaults().size() << " stuck-at faults)" << endl;
+
+    // Each remaining argument is one test vector set, graded on its own
+    vector<string> sets;
+    for (int i = 3; i < argc; i++) sets.push_back(argv[i]);
+    if (sets.empty()) sets.push_back("random:1024");
+
+    for (const string& source : sets) {
+        PatternSet patterns((int)graph.inputs.size());
+        if (source.compare(0, 7, "random:") == 0) {
+            patterns.AddRandom(max(0, atoi(source.c_str() + 7)), 1);
+        }
+        else if (!patterns.LoadText(source, error)) {
+            cerr << error << endl;
+            return 1;
+        }
+
+        FaultSimulator::Report report = simulator.Grade(patterns);
+        cout << source << ": " << report.patterns << " patterns, " << report.detected << "/"
+            << report.totalFaults << " faults detected (" << report.Coverage() << "% coverage) in "
+            << report.seconds << " s" << endl;
+    }
+    return 0;
+}
+
+// Headless stimulus run: --run circuit.bench stimulus.(txt|bin) results.(txt|bin) [--vcd trace.vcd]
+static int RunStimulus(int argc, char** argv) {
+    vector<unique_ptr<Gate>> gates;
+    WiringSystem wiringSystem;
+    string error;
+    if (argc < 5 || !CircuitFile::LoadBench(argv[2], gates, wiringSystem, error)) {
+        cerr << (argc < 5 ? "usage: --run circuit.bench stimulus.(txt|bin) results.(txt|bin) [--vcd trace.vcd] [--activity toggles.csv]" : error) << endl;
+        return 1;
+    }
+
+    string vcdPath;
+    string activityPath;
+    for (int i = 5; i + 1 < argc; i += 2) {
+        if (string(argv[i]) == "--vcd") vcdPath = argv[i + 1];
+        else if (string(argv[i]) == "--activity") activityPath = argv[i + 1];
+    }
+
+    // Toggle counts need a node for every gate, so they are taken on the
+    // netlist as drawn rather than the optimized one
+    LogicGraph graph;
+    graph.Build(gates, wiringSystem);
+    LogicGraph optimized = LogicOptimizer::Optimize(graph);
+    LogicGraph& simulated = activityPath.empty() ? optimized : graph;
+    LocalityOrder::Stats locality;
+    LocalityOrder::Apply(simulated, &locality);
+
+    StimulusRunner runner(simulated);
+
+    // Optional waveform of every INPUT and OUTPUT, one time unit per vector
+    VcdWriter vcd;
+    if (!vcdPath.empty()) {
+        for (size_t i = 0; i < simulated.inputs.size(); i++) vcd.AddSignal("in" + to_string(i));
+        for (size_t i = 0; i < simulated.outputs.size(); i++) vcd.AddSignal("out" + to_string(i));
+        if (!vcd.Open(vcdPath, "1 ns", error)) {
+            cerr << error << endl;
+            return 1;
+        }
+        runner.SetTrace(&vcd);
+    }
+
+    // Levels wide enough to split run on every core
+    unique_ptr<EvaluationPool> pool;
+    if (simulated.widestLevel >= PARALLEL_MIN_LEVEL_NODES) {
+        pool = make_unique<EvaluationPool>();
+        runner.SetPool(pool.get());
+    }
+
+    // Optional switching activity of every gate and wire
+    ToggleCounter activity;
+    if (!activityPath.empty()) {
+        runner.SetActivity(&activity);
+    }
+
+    StimulusRunner::Report report;
+    if (!runner.Run(argv[3], argv[4], report, error)) {
+        cerr << error << endl;
+        return 1;
+    }
+    vcd.Close();
+
+    if (!activityPath.empty() && !activity.Export(activityPath, simulated, gates, wiringSystem, error)) {
+        cerr << error << endl;
+        return 1;
+    }
+
+    cout << report.vectors << " vectors (" << simulated.inputs.size() << " inputs, " << simulated.outputs.size()
+        << " outputs) in " << report.seconds << " s";
+    if (report.seconds > 0) cout << " = " << (long long)(report.vectors / report.seconds) << " vectors/s";
+    cout << endl;
+    cout << "Locality order: modelled cache misses per evaluation " << locality.missesBefore << " -> "
+        << locality.missesAfter << " (" << locality.accesses << " accesses, " << locality.nodes << " nodes)" << endl;
+    if (!simulated.loops.empty()) {
+        cout << "Feedback loops: vectors evaluated one at a time, in order (" << simulated.loops.size()
+            << " loops)" << endl;
+    }
+    if (pool) {
+        cout << "Levels of " << PARALLEL_MIN_LEVEL_NODES << " nodes or more split across " << pool->GetThreadCount()
+            << " threads (widest level " << simulated.widestLevel << " nodes)" << endl;
+    }
+    return 0;
+}
+
+// Headless regression batch: --batch manifest.txt report.txt [threads]
+static int RunBatch(int argc, char** argv) {
+    BatchRunner batch;
+    string error;
+    if (argc < 4 || !batch.LoadManifest(argv[2], error)) {
+        cerr << (argc < 4 ? "usage: --batch manifest.txt report.txt [threads]" : error) << endl;
+        return 1;
+    }
+
+    BatchRunner::Summary summary = batch.Run(argc > 4 ? atoi(argv[4]) : 0);
+    if (!batch.WriteReport(argv[3], summary, error)) {
+        cerr << error << endl;
+        return 1;
+    }
+
+    for (const BatchRunner::JobResult& result : batch.GetResults()) {
+        if (!result.passed) {
+            cout << "FAIL " << result.circuit << " " << result.stimulus << ": "
+                << (result.error.empty() ? to_string(result.mismatches) + " mismatching vectors" : result.error) << endl;
+        }
+    }
+    cout << summary.passed << "/" << summary.jobs << " jobs passed, " << summary.vectors << " vectors in "
+        << summary.seconds << " s on " << summary.threads << " threads" << endl;
+    return summary.passed == summary.jobs ? 0 : 1;
+}
+
 // ================================
 // MAIN FUNCTION
 // ================================
-int main() {
-    // Initialize window and settings
+int main(int argc, char** argv) {
+    // Headless modes
+    if (argc > 1 && string(argv[1]) == "--faults") {
+        return RunFaultGrading(argc, argv);
+    }
+    if (argc > 1 && string(argv[1]) == "--run") {
+        return RunStimulus(argc, argv);
+    }
+    if (argc > 1 && string(argv[1]) == "--batch") {
+        return RunBatch(argc, argv);
+    }
+
+    // Input source: live, live and recorded (--record session.gsi [circuit.bench]),
+    // or a recorded session (--replay session.gsi [--unthrottled])
+    InputTape input;
+    string circuitPath;
+    bool unthrottled = false;
+    if (argc > 1 && (string(argv[1]) == "--record" || string(argv[1]) == "--replay")) {
+        string error;
+        bool record = string(argv[1]) == "--record";
+        if (argc < 3) {
+            cerr << "usage: --record session.gsi [circuit.bench] | --replay session.gsi [--unthrottled]" << endl;
+            return 1;
+        }
+        if (record) {
+            circuitPath = argc > 3 ? argv[3] : "";
+            if (!input.StartRecording(argv[2], circuitPath, error)) {
+                cerr << "Recording failed: " << error << endl;
+                return 1;
+            }
+        }
+        else {
+            if (!input.StartReplay(argv[2], error)) {
+                cerr << "Replay failed: " << error << endl;
+                return 1;
+            }
+            circuitPath = input.GetCircuit();
+            unthrottled = argc > 3 && string(argv[3]) == "--unthrottled";
+        }
+    }
+    else if (argc > 1) {
+        circuitPath = argv[1];
+    }
+
+    // Initialize window and settings; an unthrottled replay runs as fast as it can
     InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "Logic Gate Simulator");
-    SetTargetFPS(60);
+    SetTargetFPS(unthrottled ? 0 : 60);
 
     // ================================
     // GAME STATE VARIABLES
@@ -25,23 +244,49 @@ int main() {
     vector<unique_ptr<Gate>> gates;
     Sidebar sidebar;
     WiringSystem wiringSystem;
+    EditHistory history;
+    wiringSystem.AttachHistory(&history);
+
+    // Optional circuit to open at startup
+    if (!circuitPath.empty()) {
+        LoadCircuit(circuitPath, gates, wiringSystem, history);
+    }
 
     SimulatorMode currentMode = SimulatorMode::PLACEMENT;
     bool hasSelectedGate = false;
     GateType selectedGateType = GateType::INPUT;
+    int selectedInputCount = 2;
+    int selectedWidth = 1;              // Bus width of new gates
+    int selectedSliceOffset = 0;        // First bit taken by a new SPLIT
     int draggedGateIndex = -1;
     Vector2 dragOffset = { 0, 0 };
+    CircuitTrace trace;
+    Checkpoint checkpoint;
+    Selection selection;
+
+    // Reused every frame so steady-state frames do not allocate
+    string statusText;
+    Gate previewGate(selectedGateType, { 0, 0 }, selectedInputCount, selectedWidth, selectedSliceOffset);
+    uint64_t allocationsAtFrameStart = AllocationCounter::GetCount();
+    uint64_t allocationsLastFrame = 0;
+    FrameStats frameStats;
+    frameStats.Reserve(input.GetReplayLength());
+    GeometryBatch sceneShapes;
 
     // ================================
     // MAIN GAME LOOP
     // ================================
-    while (!WindowShouldClose()) {
-        Vector2 mousePos = GetMousePosition();
+    while (!WindowShouldClose() && input.NextFrame()) {
+        if (input.IsReplaying()) frameStats.BeginFrame();
+        Vector2 mousePos = input.GetMousePosition();
+        bool ctrlDown = input.IsKeyDown(KEY_LEFT_CONTROL) || input.IsKeyDown(KEY_RIGHT_CONTROL);
+        bool shiftDown = input.IsKeyDown(KEY_LEFT_SHIFT) || input.IsKeyDown(KEY_RIGHT_SHIFT);
+        selection.Validate(wiringSystem);
 
         // ================================
         // INPUT HANDLING
         // ================================
-        if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+        if (input.IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
             // Check sidebar button clicks
             bool shouldDeselect = false;
             bool shouldToggleMode = false;
@@ -65,39 +310,44 @@ int main() {
                     bool foundGate = false;
 
                     // Check if clicking on existing gate
-                    for (int i = 0; i < gates.size(); i++) {
-                        if (gates[i]->ContainsPoint(mousePos)) {
-                            // Toggle input states for INPUT gates when clicked
-                            if (gates[i]->GetType() == GateType::INPUT) {
-                                gates[i]->input1 = !gates[i]->input1;
-                            }
+                    int i = wiringSystem.Pick(mousePos, gates).gateIndex;
+                    if (i != -1) {
+                        // Toggle input states for INPUT gates when clicked (a bus INPUT counts up)
+                        if (gates[i]->GetType() == GateType::INPUT) {
+                            gates[i]->SetSwitchValue(gates[i]->GetSwitchValue() + 1);
+                        }
 
+                        // Every move of this drag is coalesced into one undo step; a
+                        // selected gate drags the whole selection along
+                        history.BeginStep();
+                        if (selection.Contains(i)) {
+                            selection.BeginDrag(mousePos, gates);
+                        }
+                        else {
+                            selection.Clear();
                             draggedGateIndex = i;
                             dragOffset.x = mousePos.x - gates[i]->position.x;
                             dragOffset.y = mousePos.y - gates[i]->position.y;
-                            foundGate = true;
-                            break;
                         }
+                        foundGate = true;
+                    }
+
+                    // Empty space: rubber band selection (Shift+drag while a gate type is selected)
+                    if (!foundGate && (!hasSelectedGate || shiftDown)) {
+                        selection.BeginBand(mousePos);
+                        foundGate = true;
                     }
 
                     // Place new gate if no existing gate was clicked and a gate type is selected
                     if (!foundGate && hasSelectedGate) {
-                        Vector2 gateSize = GATE_DATA.at(selectedGateType).size;
-                        Vector2 newPos = { mousePos.x - gateSize.x / 2, mousePos.y - gateSize.y / 2 };
-
-                        auto newGate = make_unique<Gate>(selectedGateType, newPos);
+                        auto newGate = make_unique<Gate>(selectedGateType, mousePos, selectedInputCount,
+                            selectedWidth, selectedSliceOffset);
+                        Vector2 gateSize = newGate->GetSize();
+                        newGate->position = { mousePos.x - gateSize.x / 2, mousePos.y - gateSize.y / 2 };
 
                         // Check if we can place it (no overlaps)
-                        bool canPlace = true;
-                        for (auto& existingGate : gates) {
-                            if (newGate->CollidesWith(*existingGate)) {
-                                canPlace = false;
-                                break;
-                            }
-                        }
-
-                        if (canPlace) {
-                            gates.push_back(move(newGate));
+                        if (wiringSystem.IsAreaFree(newGate->GetBounds())) {
+                            wiringSystem.AddGate(move(newGate), gates);
                         }
                     }
                 }
@@ -109,34 +359,177 @@ int main() {
         }
 
         // Handle right-click for wire deletion in wiring mode
-        if (IsMouseButtonPressed(MOUSE_RIGHT_BUTTON) && currentMode == SimulatorMode::WIRING && mousePos.x > SIDEBAR_WIDTH) {
+        if (input.IsMouseButtonPressed(MOUSE_RIGHT_BUTTON) && currentMode == SimulatorMode::WIRING && mousePos.x > SIDEBAR_WIDTH) {
             wiringSystem.HandleWireDeletion(mousePos, gates);
         }
 
+        // Rubber band and block drag follow the mouse until the button is released
+        if (input.IsMouseButtonDown(MOUSE_LEFT_BUTTON)) {
+            if (selection.IsBanding()) selection.UpdateBand(mousePos);
+            if (selection.IsDragging()) selection.UpdateDrag(mousePos, gates, wiringSystem);
+        }
+        else {
+            selection.EndBand(gates, wiringSystem);
+            selection.EndDrag(gates, history);
+        }
+
         // Handle gate dragging (only in placement mode)
         if (currentMode == SimulatorMode::PLACEMENT) {
-            if (IsMouseButtonDown(MOUSE_LEFT_BUTTON) && draggedGateIndex != -1) {
-                gates[draggedGateIndex]->position.x = mousePos.x - dragOffset.x;
-                gates[draggedGateIndex]->position.y = mousePos.y - dragOffset.y;
+            if (input.IsMouseButtonDown(MOUSE_LEFT_BUTTON) && draggedGateIndex != -1) {
+                Vector2 oldPos = gates[draggedGateIndex]->position;
+                Vector2 newPos = { mousePos.x - dragOffset.x, mousePos.y - dragOffset.y };
+                if (oldPos.x != newPos.x || oldPos.y != newPos.y) {
+                    wiringSystem.MoveGate(draggedGateIndex, newPos, gates);
+                    history.Record(EditDelta::Move(draggedGateIndex, oldPos, newPos));
+                }
+            }
+
+            if (input.IsMouseButtonReleased(MOUSE_LEFT_BUTTON)) {
+                draggedGateIndex = -1;
+            }
+        }
+
+        // Close the drag step once the button is up (also covers mode switches mid-drag)
+        if (!input.IsMouseButtonDown(MOUSE_LEFT_BUTTON)) {
+            history.EndStep();
+        }
+
+        // Handle gate deletion with DELETE key (the selection, or the last dragged gate)
+        if (input.IsKeyPressed(KEY_DELETE)) {
+            if (!selection.IsEmpty()) {
+                selection.Delete(gates, wiringSystem);
+            }
+            else if (draggedGateIndex != -1) {
+                wiringSystem.RemoveGate(draggedGateIndex, gates);
             }
+            draggedGateIndex = -1;
+        }
 
-            if (IsMouseButtonReleased(MOUSE_LEFT_BUTTON)) {
+        // Select all, copy and paste at the mouse (Ctrl+A, Ctrl+C, Ctrl+V)
+        if (ctrlDown && input.IsKeyPressed(KEY_A)) {
+            selection.SelectAll(gates, wiringSystem);
+        }
+        if (ctrlDown && input.IsKeyPressed(KEY_C)) {
+            selection.Copy(gates, wiringSystem);
+        }
+        if (ctrlDown && input.IsKeyPressed(KEY_V) && selection.HasClipboard()) {
+            if (selection.Paste(mousePos, gates, wiringSystem)) {
                 draggedGateIndex = -1;
             }
+            else {
+                cerr << "Paste failed: the block would overlap existing gates" << endl;
+            }
         }
 
-        // Handle gate deletion with DELETE key
-        if (IsKeyPressed(KEY_DELETE) && draggedGateIndex != -1) {
-            wiringSystem.RemoveWiresForGate(draggedGateIndex);
-            gates.erase(gates.begin() + draggedGateIndex);
-            wiringSystem.UpdateWireIndices(draggedGateIndex);
+        // Pin count for new AND/OR/NAND/NOR gates
+        if (input.IsKeyPressed(KEY_EQUAL) || input.IsKeyPressed(KEY_KP_ADD)) {
+            selectedInputCount = min(selectedInputCount + 1, MAX_GATE_INPUTS);
+        }
+        if (input.IsKeyPressed(KEY_MINUS) || input.IsKeyPressed(KEY_KP_SUBTRACT)) {
+            selectedInputCount = max(selectedInputCount - 1, 2);
+        }
+
+        // Bus width of new gates (1, 2, 4 .. 64 bits) and the first bit a new SPLIT takes
+        if (input.IsKeyPressed(KEY_RIGHT_BRACKET)) {
+            selectedWidth = min(selectedWidth * 2, MAX_BUS_WIDTH);
+        }
+        if (input.IsKeyPressed(KEY_LEFT_BRACKET)) {
+            selectedWidth = max(selectedWidth / 2, 1);
+        }
+        if (input.IsKeyPressed(KEY_PERIOD)) {
+            selectedSliceOffset = min(selectedSliceOffset + 1, MAX_BUS_WIDTH - 1);
+        }
+        if (input.IsKeyPressed(KEY_COMMA)) {
+            selectedSliceOffset = max(selectedSliceOffset - 1, 0);
+        }
+
+        // Open a .bench file dropped onto the window
+        if (input.IsFileDropped()) {
+            LoadCircuit(input.GetDroppedFile(), gates, wiringSystem, history);
             draggedGateIndex = -1;
         }
 
+        // Undo / redo (Ctrl+Z, Ctrl+Y or Ctrl+Shift+Z)
+        if (ctrlDown && input.IsKeyPressed(KEY_Z) && !shiftDown) {
+            if (history.Undo(gates, wiringSystem)) draggedGateIndex = -1;
+        }
+        else if (ctrlDown && (input.IsKeyPressed(KEY_Y) || (input.IsKeyPressed(KEY_Z) && shiftDown))) {
+            if (history.Redo(gates, wiringSystem)) draggedGateIndex = -1;
+        }
+
+        // Toggle evaluation through the optimized netlist (F2)
+        if (input.IsKeyPressed(KEY_F2)) {
+            wiringSystem.SetOptimizedEvaluation(!wiringSystem.IsOptimizedEvaluation());
+        }
+
+        // Toggle four-valued 0/1/X/Z evaluation (F7)
+        if (input.IsKeyPressed(KEY_F7)) {
+            wiringSystem.SetFourValued(!wiringSystem.IsFourValued());
+        }
+
+        // Lay the circuit out for cache-friendly evaluation and report the gain
+        if (input.IsKeyPressed(KEY_F8)) {
+            const LocalityOrder::Stats& stats = wiringSystem.ReorderForLocality(gates);
+            cout << "Locality order: " << stats.nodes << " nodes, " << stats.accesses
+                << " accesses per evaluation, modelled cache misses " << stats.missesBefore << " -> "
+                << stats.missesAfter << endl;
+        }
+
+        // Waveform trace of the selected gates, or of everything when nothing is
+        // selected (F3 starts / stops)
+        if (input.IsKeyPressed(KEY_F3)) {
+            if (trace.IsActive()) {
+                trace.Stop();
+            }
+            else {
+                string error;
+                if (!trace.Start("trace.vcd", gates, wiringSystem, selection.GetGates(), error)) {
+                    cerr << "Trace failed: " << error << endl;
+                }
+            }
+        }
+
+        // Switching activity: F4 shows it as a wire heat map, F6 writes activity.csv
+        if (input.IsKeyPressed(KEY_F4)) {
+            wiringSystem.SetHeatMap(!wiringSystem.IsHeatMap());
+        }
+        if (input.IsKeyPressed(KEY_F6)) {
+            string error;
+            if (!wiringSystem.ExportActivity("activity.csv", gates, error)) {
+                cerr << "Activity export failed: " << error << endl;
+            }
+        }
+
+        // Simulation checkpoint: F5 takes one (and writes checkpoint.gsc), F9 goes
+        // back to it, or to the file if none was taken since the program started
+        if (input.IsKeyPressed(KEY_F5)) {
+            string error;
+            wiringSystem.SaveCheckpoint(checkpoint, gates);
+            if (!checkpoint.Save("checkpoint.gsc", error)) {
+                cerr << "Checkpoint save failed: " << error << endl;
+            }
+        }
+        if (input.IsKeyPressed(KEY_F9)) {
+            string error;
+            bool ok = checkpoint.IsEmpty() ? checkpoint.Load("checkpoint.gsc", error) : true;
+            if (!ok || !wiringSystem.RestoreCheckpoint(checkpoint, gates, error)) {
+                cerr << "Checkpoint restore failed: " << error << endl;
+            }
+        }
+
+        // Save (Ctrl+S)
+        if (ctrlDown && input.IsKeyPressed(KEY_S)) {
+            string error;
+            if (!CircuitFile::SaveBench("circuit.bench", gates, wiringSystem, error)) {
+                cerr << "Save failed: " << error << endl;
+            }
+        }
+
         // ================================
         // LOGIC COMPUTATION
         // ================================
         wiringSystem.UpdateSignals(gates);
+        trace.Sample(input.GetTime(), wiringSystem);
 
         // ================================
         // RENDERING
@@ -147,32 +540,63 @@ int main() {
         // Draw sidebar
         sidebar.Draw(hasSelectedGate, selectedGateType, currentMode);
 
+        // Gate bodies, pins and wires are collected into one triangle list and
+        // drawn with a single call; all text follows on top
+        sceneShapes.Clear();
+
         // Draw all placed gates
         for (int i = 0; i < gates.size(); i++) {
-            bool highlight = (draggedGateIndex == i);
-            gates[i]->Draw(false, highlight);
+            bool highlight = (draggedGateIndex == i) || selection.Contains(i);
+            gates[i]->Draw(sceneShapes, false, highlight);
         }
 
         // Draw wires
-        wiringSystem.DrawWires(gates, mousePos);
+        wiringSystem.DrawWires(gates, mousePos, sceneShapes);
 
         // Draw preview gate when hovering in main area (placement mode only)
-        if (currentMode == SimulatorMode::PLACEMENT && hasSelectedGate && mousePos.x > SIDEBAR_WIDTH && draggedGateIndex == -1) {
-            Vector2 gateSize = GATE_DATA.at(selectedGateType).size;
-            Gate previewGate(selectedGateType, { mousePos.x - gateSize.x / 2, mousePos.y - gateSize.y / 2 });
-            previewGate.Draw(true); // true = preview mode
+        bool showPreview = currentMode == SimulatorMode::PLACEMENT && hasSelectedGate && mousePos.x > SIDEBAR_WIDTH && draggedGateIndex == -1;
+        if (showPreview) {
+            int offset = Gate::ClampSliceOffset(selectedGateType, selectedSliceOffset);
+            if (previewGate.GetType() != selectedGateType ||
+                previewGate.GetInputCount() != Gate::ClampInputCount(selectedGateType, selectedInputCount) ||
+                previewGate.GetWidth() != Gate::ClampWidth(selectedGateType, selectedWidth, offset) ||
+                previewGate.GetSliceOffset() != offset) {
+                previewGate = Gate(selectedGateType, mousePos, selectedInputCount, selectedWidth, selectedSliceOffset);
+            }
+            Vector2 gateSize = previewGate.GetSize();
+            previewGate.position = { mousePos.x - gateSize.x / 2, mousePos.y - gateSize.y / 2 };
+            previewGate.Draw(sceneShapes, true); // true = preview mode
         }
 
+        sceneShapes.Submit();
+        for (const auto& gate : gates) {
+            gate->DrawLabels();
+        }
+        wiringSystem.DrawWireLabels();
+        if (showPreview) {
+            previewGate.DrawLabels(true);
+        }
+
+        selection.Draw();
+
         // Highlight connection points in wiring mode
         if (currentMode == SimulatorMode::WIRING) {
             wiringSystem.HighlightConnectionPoints(gates, mousePos);
         }
 
-        // Draw UI information
-        string statusText = "Mode: " + string(currentMode == SimulatorMode::PLACEMENT ? "PLACEMENT" : "WIRING");
+        // Draw UI information (appended in place; TextFormat uses raylib's static buffers)
+        statusText = "Mode: ";
+        statusText += currentMode == SimulatorMode::PLACEMENT ? "PLACEMENT" : "WIRING";
         if (currentMode == SimulatorMode::PLACEMENT) {
             if (hasSelectedGate) {
-                statusText += " | Selected: " + string(GATE_DATA.at(selectedGateType).label);
+                statusText += " | Selected: ";
+                statusText += GetGateInfo(selectedGateType).label;
+                int pins = Gate::ClampInputCount(selectedGateType, selectedInputCount);
+                if (pins > 1) statusText += TextFormat(" (%i inputs)", pins);
+                int offset = Gate::ClampSliceOffset(selectedGateType, selectedSliceOffset);
+                int bits = Gate::ClampWidth(selectedGateType, selectedWidth, offset);
+                if (bits > 1) statusText += TextFormat(" %i-bit bus", bits);
+                if (selectedGateType == GateType::SPLIT) statusText += TextFormat(" from bit %i", offset);
             }
             else {
                 statusText += " | Selected: None";
@@ -182,16 +606,65 @@ int main() {
             statusText += " | Click output then input to connect";
         }
 
+        if (!selection.IsEmpty()) {
+            statusText += TextFormat(" | %i gates selected", (int)selection.GetGates().size());
+        }
+
+        if (wiringSystem.IsOptimizedEvaluation()) {
+            const LogicOptimizer::Stats& stats = wiringSystem.GetOptimizerStats();
+            statusText += TextFormat(" | Optimized: %i -> %i nodes", stats.nodesBefore, stats.nodesAfter);
+        }
+
+        if (wiringSystem.IsFourValued()) {
+            statusText += " | Four-valued";
+        }
+
+        if (wiringSystem.GetLoopCount() > 0) {
+            statusText += TextFormat(" | Loops: %i", wiringSystem.GetLoopCount());
+            if (wiringSystem.GetOscillatingLoopCount() > 0) {
+                statusText += TextFormat(" (%i oscillating)", wiringSystem.GetOscillatingLoopCount());
+            }
+        }
+
+        if (trace.IsActive()) {
+            statusText += TextFormat(" | Tracing %i signals (%llu changes)", (int)trace.GetSignalCount(),
+                (unsigned long long)trace.GetChangeCount());
+        }
+
+        if (wiringSystem.IsHeatMap()) {
+            const ToggleCounter& activity = wiringSystem.GetActivity();
+            statusText += TextFormat(" | Heat map: up to %llu toggles in %llu frames",
+                (unsigned long long)activity.GetMaxCount(), (unsigned long long)activity.GetSampleCount());
+        }
+
+        statusText += TextFormat(" | Heap allocations last frame: %llu", (unsigned long long)allocationsLastFrame);
+
         DrawText(statusText.c_str(), SIDEBAR_WIDTH + 10, 10, 16, BLACK);
 
         // Show controls
-        DrawText("Controls: DEL = Delete selected gate, Right-click = Delete wire",
+        DrawText("Controls: DEL = Delete selected gate, Right-click = Delete wire, Drag on empty space (Shift+drag with a gate selected) = Select, Ctrl+A / Ctrl+C / Ctrl+V = Select all / Copy / Paste, Ctrl+Z / Ctrl+Y = Undo / Redo, +/- = Gate inputs, [ / ] = Bus width, , / . = Split offset, F2 = Optimized evaluation, F7 = 0/1/X/Z evaluation, F8 = Locality order, F3 = Trace to VCD, F4 / F6 = Activity heat map / Export, F5 / F9 = Checkpoint / Restore, Ctrl+S = Save, drop a .bench file to open",
             SIDEBAR_WIDTH + 10, SCREEN_HEIGHT - 30, 12, DARKGRAY);
 
         EndDrawing();
+        if (input.IsReplaying()) frameStats.EndFrame();
+
+        uint64_t allocations = AllocationCounter::GetCount();
+        allocationsLastFrame = allocations - allocationsAtFrameStart;
+        allocationsAtFrameStart = allocations;
+    }
+
+    // A replay ends with its frame-time distribution
+    if (input.IsReplaying()) {
+        if (input.GetFrameCount() < input.GetReplayLength()) {
+            cout << "Replay stopped after " << input.GetFrameCount() << " of " << input.GetReplayLength() << " frames" << endl;
+        }
+        cout << FrameStats::Format(frameStats.Summarize());
     }
 
     // Cleanup
+    input.Stop();
+    trace.Stop();
+    sceneShapes.Unload();
     CloseWindow();
     return 0;
 }
\ No newline at end of file
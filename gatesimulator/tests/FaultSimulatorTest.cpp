@@ -0,0 +1,135 @@
+// ================================
+// FAULT SIMULATOR REGRESSION TEST
+// ================================
+// Grades an SR latch feeding a stuck-at site (Y = AND(Q, E)) and checks the
+// first detecting pattern of every fault against a serial reference that
+// simulates each faulty machine on its own, pattern by pattern.
+//
+// Build from gatesimulator/ against every TESTSIMULAtor source but main.cpp:
+//   g++ -std=c++14 -pthread -ITESTSIMULAtor tests/FaultSimulatorTest.cpp
+//       $(ls TESTSIMULAtor/*.cpp | grep -v main.cpp) -lraylib -o FaultSimulatorTest
+// Exit code 0 when every fault matches.
+
+#include "CircuitFile.h"
+#include "FaultSimulator.h"
+#include "WiringSystem.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+
+using namespace std;
+
+static const char* BENCH_PATH = "FaultSimulatorTest.bench";
+
+// First detecting pattern of every fault, one faulty machine at a time
+static vector<int> GradeSerially(const LogicGraph& graph, const FaultSimulator& simulator, const PatternSet& patterns) {
+    const vector<FaultSimulator::Fault>& faults = simulator.GetFaults();
+    int nodes = graph.NodeCount();
+    vector<uint64_t> good(nodes, 0);
+    vector<vector<uint64_t>> faulty(faults.size(), vector<uint64_t>(nodes, 0));
+    vector<int> firstDetection(faults.size(), -1);
+
+    for (int block = 0; block < patterns.GetBlockCount(); block++) {
+        uint64_t laneMask = patterns.GetLaneMask(block);
+        for (size_t i = 0; i < graph.inputs.size(); i++) good[graph.inputs[i]] = patterns.Word(block, (int)i);
+        graph.Evaluate(good.data());
+
+        for (size_t f = 0; f < faults.size(); f++) {
+            if (firstDetection[f] >= 0) continue;
+            const FaultSimulator::Fault& fault = faults[f];
+            vector<uint64_t>& value = faulty[f];
+            int site = graph.gateNode[fault.gate];
+            uint64_t stuck = fault.stuckAt ? ~0ull : 0;
+            auto evaluate = [&](int n) {
+                if (n != site) return graph.EvaluateNode(n, value.data());
+                return fault.pin < 0 ? stuck : graph.EvaluateNodeWithPin(n, value.data(), fault.pin, stuck);
+            };
+
+            // Same order and loop settling as LogicGraph::Evaluate
+            value[0] = 0;
+            value[1] = ~0ull;
+            for (int input : graph.inputs) value[input] = input == site && fault.pin < 0 ? stuck : good[input];
+            for (size_t i = 0; i < graph.order.size(); i++) {
+                int n = graph.order[i];
+                int loop = graph.loopOf[n];
+                if (loop < 0) {
+                    if (graph.ops[n] != NodeOp::INPUT) value[n] = evaluate(n);
+                    continue;
+                }
+                const LogicGraph::Loop& span = graph.loops[loop];
+                for (int pass = 0; pass < MAX_LOOP_ITERATIONS; pass++) {
+                    bool moved = false;
+                    for (int j = span.begin; j < span.end; j++) {
+                        int m = graph.order[j];
+                        uint64_t next = evaluate(m);
+                        if (next != value[m]) { value[m] = next; moved = true; }
+                    }
+                    if (!moved) break;
+                }
+                i = span.end - 1;
+            }
+
+            uint64_t detectedLanes = 0;
+            for (int output : graph.outputs) detectedLanes |= (value[output] ^ good[output]) & laneMask;
+            if (detectedLanes) firstDetection[f] = block * 64 + LowestBit(detectedLanes);
+        }
+    }
+    return firstDetection;
+}
+
+// Grade one pattern set with the given thread count and compare with the reference
+static bool Check(const char* name, const LogicGraph& graph, const PatternSet& patterns, int threads) {
+    FaultSimulator simulator(graph);
+    FaultSimulator::Report report = simulator.Grade(patterns, threads);
+    vector<int> expected = GradeSerially(graph, simulator, patterns);
+
+    int mismatches = 0;
+    for (size_t f = 0; f < expected.size(); f++) {
+        if (report.firstDetection[f] == expected[f]) continue;
+        cout << name << ": " << simulator.Describe(simulator.GetFaults()[f])
+             << " first detected by " << report.firstDetection[f] << ", expected " << expected[f] << endl;
+        mismatches++;
+    }
+    cout << name << " (" << threads << " threads): " << report.detected << "/" << report.totalFaults
+         << " detected, " << mismatches << " mismatches" << endl;
+    return mismatches == 0;
+}
+
+int main() {
+    {
+        ofstream bench(BENCH_PATH);
+        bench << "INPUT(S)\nINPUT(R)\nINPUT(E)\nOUTPUT(Y)\n"
+              << "Q = NAND(S, QB)\nQB = NAND(R, Q)\nY = AND(Q, E)\n";
+    }
+
+    vector<unique_ptr<Gate>> gates;
+    WiringSystem wiring;
+    string error;
+    bool loaded = CircuitFile::LoadBench(BENCH_PATH, gates, wiring, error);
+    remove(BENCH_PATH);
+    if (!loaded) {
+        cout << error << endl;
+        return 1;
+    }
+    LogicGraph graph;
+    graph.Build(gates, wiring);
+
+    // Set (S=0), hold, reset (R=0), hold: Y only sees the latch through E, so
+    // the later patterns depend on the state left by the earlier ones
+    PatternSet sequence((int)graph.inputs.size());
+    const unsigned char steps[][3] = {
+        { 0, 1, 0 }, { 1, 1, 1 }, { 1, 0, 0 }, { 1, 1, 1 }, { 0, 1, 1 }, { 1, 1, 0 }, { 1, 1, 1 }
+    };
+    for (const auto& step : steps) sequence.AddPattern(vector<unsigned char>(step, step + 3));
+
+    PatternSet random((int)graph.inputs.size());
+    random.AddRandom(500, 7);
+
+    bool ok = graph.loops.size() == 1;
+    ok = Check("sequence", graph, sequence, 1) && ok;
+    ok = Check("random", graph, random, 1) && ok;
+    ok = Check("random", graph, random, 3) && ok;
+    cout << (ok ? "PASS" : "FAIL") << endl;
+    return ok ? 0 : 1;
+}
\ No newline at end of file